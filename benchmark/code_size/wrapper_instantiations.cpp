@@ -0,0 +1,66 @@
+// Code-size benchmark: stores many distinct callables, of a few signatures, in task and
+// once_function. Only the text size of the object file is measured, see the
+// code_size_benchmarks target.
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ruby/invocable_traits/once_function.hpp>
+#include <ruby/invocable_traits/task.hpp>
+
+#ifndef RUBY_BENCH_CALLABLES
+#define RUBY_BENCH_CALLABLES 100
+#endif
+
+namespace
+{
+  /** A distinct closure type per 'N', with small trivially copyable captures. */
+  template<std::size_t N>
+  auto small_closure(int * sink)
+  {
+    return [sink](int x) { *sink += x + int(N); };
+  }
+
+  /** A distinct closure type per 'N', owning a resource. */
+  template<std::size_t N>
+  auto owning_closure(int * sink)
+  {
+    return [sink, text = std::make_unique<std::string>(N % 7, 'x')](int x) {
+      *sink += x + int(text->size());
+    };
+  }
+
+  /** A distinct closure type per 'N', too large to be stored inline. */
+  template<std::size_t N>
+  auto large_closure(int * sink)
+  {
+    return [sink, pad = std::array<long, 8> {long(N)}](int x) { *sink += x + int(pad[0]); };
+  }
+
+  template<std::size_t... N>
+  void fill(std::vector<ruby::inv::task> & tasks,
+            std::vector<ruby::inv::once_function<void(int)>> & calls, int * sink,
+            std::index_sequence<N...>)
+  {
+    using call = ruby::inv::once_function<void(int)>;
+    (calls.push_back(call(small_closure<N>(sink))), ...);
+    (calls.push_back(call(owning_closure<N>(sink))), ...);
+    (calls.push_back(call(large_closure<N>(sink))), ...);
+    (tasks.push_back(ruby::inv::task([call = small_closure<N>(sink)] { call(1); })), ...);
+  }
+} // namespace
+
+int run(int * sink)
+{
+  auto tasks = std::vector<ruby::inv::task>();
+  auto calls = std::vector<ruby::inv::once_function<void(int)>>();
+  fill(tasks, calls, sink, std::make_index_sequence<RUBY_BENCH_CALLABLES>());
+  for(auto & call : calls)
+    std::move(call)(1);
+  for(auto & t : tasks)
+    t();
+  return *sink;
+}
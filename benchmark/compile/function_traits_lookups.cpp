@@ -0,0 +1,102 @@
+// Compile-time benchmark: decomposes and rebuilds many distinct function types with
+// function_traits and make_function, with the specialization matching strategy selected by
+// RUBY_INVOCABLE_TRAITS_STAGED_MATCHING. Only the compilation is timed, see the
+// compile_benchmarks target.
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <ruby/invocable_traits/function_traits.hpp>
+
+#ifndef RUBY_BENCH_SIGNATURES
+#define RUBY_BENCH_SIGNATURES 10000
+#endif
+
+namespace
+{
+  template<std::size_t N>
+  struct arg
+  {};
+
+  /** Signatures as member functions and lambdas produce them: half are unqualified or const. */
+  template<std::size_t N, std::size_t Form = N % 8>
+  struct signature;
+
+  template<std::size_t N>
+  struct signature<N, 0>
+  {
+    using type = arg<N>(arg<N>, int);
+  };
+
+  template<std::size_t N>
+  struct signature<N, 1>
+  {
+    using type = arg<N>(arg<N>, int) const;
+  };
+
+  template<std::size_t N>
+  struct signature<N, 2>
+  {
+    using type = arg<N>(arg<N>, int) noexcept;
+  };
+
+  template<std::size_t N>
+  struct signature<N, 3>
+  {
+    using type = arg<N>(arg<N>, int) const noexcept;
+  };
+
+  template<std::size_t N>
+  struct signature<N, 4>
+  {
+    using type = arg<N>(arg<N>, int) &;
+  };
+
+  template<std::size_t N>
+  struct signature<N, 5>
+  {
+    using type = arg<N>(arg<N>, int) const &;
+  };
+
+  template<std::size_t N>
+  struct signature<N, 6>
+  {
+    using type = arg<N>(arg<N>, int) &&;
+  };
+
+  template<std::size_t N>
+  struct signature<N, 7>
+  {
+    using type = arg<N>(arg<N>, int, ...) volatile;
+  };
+
+  template<std::size_t N>
+  constexpr bool lookup()
+  {
+    using namespace ruby::inv;
+    using T = typename signature<N>::type;
+    return function_arity_v<T> == 2 &&
+           std::is_same_v<function_ret_t<T>, arg<N>> &&
+           std::is_same_v<function_remove_qualifiers_t<T>,
+                          std::conditional_t<N % 8 == 7, arg<N>(arg<N>, int, ...),
+                                             arg<N>(arg<N>, int)>>;
+  }
+
+  // Folds are kept short: checking one fold over every signature is quadratic in GCC.
+  template<std::size_t Block, std::size_t... I>
+  constexpr bool lookup_block(std::index_sequence<I...>)
+  {
+    return (lookup<Block * 100 + I>() && ...);
+  }
+
+  template<std::size_t... Block>
+  constexpr bool lookup_all(std::index_sequence<Block...>)
+  {
+    return (lookup_block<Block>(std::make_index_sequence<100>()) && ...);
+  }
+
+  static_assert(lookup_all(std::make_index_sequence<RUBY_BENCH_SIGNATURES / 100>()));
+} // namespace
+
+int main()
+{}
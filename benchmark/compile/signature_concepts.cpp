@@ -0,0 +1,51 @@
+// Compile-time benchmark: constrains many distinct callback types with either
+// std::is_invocable_r (RUBY_BENCH_IS_INVOCABLE_R defined) or ruby::inv::invocable_compatible.
+// Only the compilation is timed, see the compile_benchmarks target.
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <ruby/invocable_traits/invocable_traits.hpp>
+
+#ifndef RUBY_BENCH_CALLBACKS
+#define RUBY_BENCH_CALLBACKS 2000
+#endif
+
+namespace
+{
+  template<std::size_t N>
+  struct callback
+  {
+    long operator()(int, std::string const &, double) const
+    {
+      return N;
+    }
+  };
+
+  template<typename F>
+  concept long_callback =
+#ifdef RUBY_BENCH_IS_INVOCABLE_R
+      std::is_invocable_r_v<long, F, int, std::string const &, double>;
+#else
+      ruby::inv::invocable_compatible<F, long(int, std::string const &, double)>;
+#endif
+
+  template<typename F>
+    requires long_callback<F>
+  constexpr bool accept()
+  {
+    return true;
+  }
+
+  template<std::size_t... I>
+  constexpr bool accept_all(std::index_sequence<I...>)
+  {
+    return (accept<callback<I>>() && ...);
+  }
+
+  static_assert(accept_all(std::make_index_sequence<RUBY_BENCH_CALLBACKS>()));
+} // namespace
+
+int main()
+{}
@@ -0,0 +1,227 @@
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <ruby/invocable_traits/callback_arena.hpp>
+#include <ruby/invocable_traits/deferred_call.hpp>
+#include <ruby/invocable_traits/handler_registry.hpp>
+#include <ruby/invocable_traits/invocable_traits.hpp>
+#include <ruby/invocable_traits/task.hpp>
+
+#include "./harness.hpp"
+
+namespace
+{
+  using namespace ruby::inv;
+
+  constexpr std::size_t calls = 1 << 20;
+
+  struct payload
+  {
+    std::array<long, 8> values;
+  };
+
+  long weight(int x)
+  {
+    return x;
+  }
+
+  long weight(double x)
+  {
+    return static_cast<long>(x);
+  }
+
+  long weight(std::string const & x)
+  {
+    return static_cast<long>(x.size());
+  }
+
+  long weight(payload const & x)
+  {
+    return x.values[0] + x.values[7];
+  }
+
+  /** Value-initialized arguments for 'Sig': the decayed function_args_t. */
+  template<typename Sig>
+  auto make_arguments()
+  {
+    return invocable_decayed_args_t<Sig>();
+  }
+
+  template<typename Sig>
+  struct shape;
+
+  /** The callables compared for the argument shape 'Args...'. */
+  template<typename R, typename... Args>
+  struct shape<R(Args...)>
+  {
+    static R compute(Args... args)
+    {
+      return static_cast<R>((0L + ... + weight(args)));
+    }
+
+    struct base
+    {
+      virtual ~base() = default;
+      virtual R compute_virtual(Args... args) const = 0;
+    };
+
+    struct target final : base
+    {
+      long offset = 1;
+
+      R compute_member(Args... args) const
+      {
+        return static_cast<R>(offset + (0L + ... + weight(args)));
+      }
+
+      R compute_virtual(Args... args) const override
+      {
+        return static_cast<R>(offset + (0L + ... + weight(args)));
+      }
+    };
+
+    struct functor
+    {
+      R operator()(Args... args) const
+      {
+        return compute(args...);
+      }
+    };
+  };
+
+  /** One call, kept out of line so that its code can be measured. */
+  template<typename Case, typename... Args>
+  [[gnu::noinline]] auto call_site(Case & site, Args const &... args)
+  {
+    return site(args...);
+  }
+
+  template<typename Case, typename Arguments>
+  void run_case(char const * group, char const * name, Case site, Arguments const & arguments)
+  {
+    auto const nanoseconds = benchmark::measure(
+        [&] {
+          for(std::size_t i = 0; i < calls; ++i) {
+            benchmark::clobber_memory();
+            benchmark::do_not_optimize(
+                std::apply([&](auto const &... args) { return call_site(site, args...); },
+                           arguments));
+          }
+        },
+        calls);
+
+    auto const * address = std::apply(
+        [](auto const &... args) {
+          return reinterpret_cast<void const *>(
+              &call_site<Case, std::remove_cvref_t<decltype(args)>...>);
+        },
+        arguments);
+    benchmark::report(group, name, nanoseconds, benchmark::code_size(address));
+  }
+
+  template<typename Sig>
+  void run_shape(char const * group)
+  {
+    using S = shape<Sig>;
+    using result = function_ret_t<Sig>;
+
+    auto arguments = make_arguments<Sig>();
+    auto target = typename S::target();
+    auto const & base = static_cast<typename S::base const &>(target);
+
+    run_case(group, "direct call", [](auto const &... args) { return S::compute(args...); },
+             arguments);
+
+    auto pointer = &S::compute;
+    run_case(group, "function pointer",
+             [&pointer](auto const &... args) { return pointer(args...); }, arguments);
+
+    // Member function pointers, with the class taken from member_function_pointer_traits.
+    using member = decltype(&S::target::compute_member);
+    using member_class = member_function_pointer_class_t<member>;
+    static_assert(std::same_as<member_function_pointer_function_t<member>,
+                               function_add_const_t<Sig>>);
+
+    auto member_pointer = &member_class::compute_member;
+    run_case(group, "member function pointer",
+             [&](auto const &... args) { return (target.*member_pointer)(args...); },
+             arguments);
+
+    auto virtual_pointer = &S::base::compute_virtual;
+    run_case(group, "virtual member function pointer",
+             [&](auto const &... args) { return (base.*virtual_pointer)(args...); }, arguments);
+
+    run_case(group, "virtual call",
+             [&](auto const &... args) { return base.compute_virtual(args...); }, arguments);
+
+    auto function = std::function<Sig>(&S::compute);
+    run_case(group, "std::function",
+             [&function](auto const &... args) { return function(args...); }, arguments);
+
+    auto functor = typename S::functor();
+    auto reference = std::cref(functor);
+    run_case(group, "std::reference_wrapper",
+             [&reference](auto const &... args) { return reference(args...); }, arguments);
+
+    // Wrappers shipped by the library.
+    auto registry = make_handler_registry<Sig>(named_handler {"compute", functor});
+    run_case(group, "handler_registry::invoke",
+             [&registry](auto const &... args) { return registry.invoke(0, args...); },
+             arguments);
+
+    auto sink = result();
+    auto arena = callback_arena<void(function_arg_t<Sig, 0>)>();
+    arena.push(
+        [&sink](function_arg_t<Sig, 0> first) { sink = static_cast<result>(weight(first)); });
+    run_case(group, "callback_arena::invoke (first arg)",
+             [&](auto const & first, auto const &...) {
+               arena.invoke(first);
+               return sink;
+             },
+             arguments);
+
+    run_case(group, "deferred_call (build + call)",
+             [](auto const &... args) { return deferred_call(&S::compute, args...)(); },
+             arguments);
+
+    run_case(group, "task (build + call)",
+             [&sink](auto const &... args) {
+               auto job = task([&sink, args...] { sink = S::compute(args...); });
+               job();
+               return sink;
+             },
+             arguments);
+  }
+
+  struct record
+  {
+    long value;
+  };
+
+  void run_member_object()
+  {
+    using member = long record::*;
+    static_assert(std::same_as<invocable_function_t<member>, long(record &)>);
+
+    auto object = record {42};
+    auto pointer = &record::value;
+    run_case("member object", "pointer to member object",
+             [&pointer](record const & r) { return r.*pointer; }, std::tuple<record>(object));
+    run_case("member object", "std::invoke on member object",
+             [&pointer](record const & r) { return std::invoke(pointer, r); },
+             std::tuple<record>(object));
+  }
+} // namespace
+
+int main()
+{
+  run_shape<int(int)>("int(int)");
+  run_shape<double(double, double)>("double(double, double)");
+  run_shape<std::size_t(std::string const &)>("size_t(string const&)");
+  run_shape<long(payload, int)>("long(payload, int)");
+  run_member_object();
+}
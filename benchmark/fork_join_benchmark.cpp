@@ -0,0 +1,138 @@
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ruby/invocable_traits/work_stealing_executor.hpp>
+
+#include "./harness.hpp"
+
+namespace
+{
+  /** Baseline: one queue protected by a mutex, workers sleeping on a condition variable. */
+  class mutex_pool
+  {
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+    std::vector<std::jthread> m_threads;
+
+    void work()
+    {
+      for(;;) {
+        auto lock = std::unique_lock(m_mutex);
+        m_ready.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+        if(m_tasks.empty())
+          return;
+        auto next = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        lock.unlock();
+        next();
+      }
+    }
+
+  public:
+    explicit mutex_pool(std::size_t threads)
+    {
+      for(std::size_t i = 0; i < threads; ++i)
+        m_threads.emplace_back([this] { work(); });
+    }
+
+    ~mutex_pool()
+    {
+      {
+        auto lock = std::scoped_lock(m_mutex);
+        m_stopping = true;
+      }
+      m_ready.notify_all();
+      m_threads.clear();
+    }
+
+    template<typename F>
+    auto submit(F fn) -> std::future<decltype(fn())>
+    {
+      auto packaged =
+          std::make_shared<std::packaged_task<decltype(fn())()>>(std::move(fn));
+      auto result = packaged->get_future();
+      {
+        auto lock = std::scoped_lock(m_mutex);
+        m_tasks.emplace_back([packaged] { (*packaged)(); });
+      }
+      m_ready.notify_one();
+      return result;
+    }
+  };
+
+  constexpr std::size_t flat_tasks = 20000;
+
+  int work_item(int i) noexcept
+  {
+    auto x = static_cast<unsigned>(i);
+    for(int k = 0; k < 64; ++k)
+      x = x * 1664525u + 1013904223u;
+    return static_cast<int>(x >> 8);
+  }
+
+  template<typename Pool>
+  void flat_fork_join(Pool & pool)
+  {
+    using future = decltype(pool.submit([] { return work_item(0); }));
+
+    auto futures = std::vector<future>();
+    futures.reserve(flat_tasks);
+    for(std::size_t i = 0; i < flat_tasks; ++i)
+      futures.push_back(pool.submit([i] { return work_item(static_cast<int>(i)); }));
+
+    long long sum = 0;
+    for(auto & f : futures)
+      sum += f.get();
+    benchmark::do_not_optimize(sum);
+  }
+
+  long long fib(ruby::inv::work_stealing_executor & executor, int n)
+  {
+    if(n < 16)
+      return n < 2 ? n : fib(executor, n - 1) + fib(executor, n - 2);
+
+    auto left = executor.submit([&executor, n] { return fib(executor, n - 1); });
+    auto const right = fib(executor, n - 2);
+    return left.get() + right;
+  }
+
+  constexpr int fib_n = 30;
+  constexpr std::size_t fib_forks = 832039 / 987; // roughly fib(30) / fib(16)
+} // namespace
+
+int main()
+{
+  for(std::size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+    auto const label = std::to_string(threads) + " threads";
+
+    {
+      auto pool = mutex_pool(threads);
+      benchmark::report("flat fork/join mutex pool",
+                        label.c_str(),
+                        benchmark::measure([&] { flat_fork_join(pool); }, flat_tasks));
+    }
+
+    {
+      auto executor = ruby::inv::work_stealing_executor(threads);
+      benchmark::report("flat fork/join work stealing",
+                        label.c_str(),
+                        benchmark::measure([&] { flat_fork_join(executor); }, flat_tasks));
+
+      auto const nested = benchmark::measure(
+          [&] {
+            auto result = executor.submit([&executor] { return fib(executor, fib_n); });
+            benchmark::do_not_optimize(result.get());
+          },
+          fib_forks);
+      benchmark::report("nested fork/join work stealing", label.c_str(), nested);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <elf.h>
+#include <link.h>
+#endif
+
+namespace benchmark
+{
+  /** Prevents the compiler from optimizing away the computation of 'value'. */
+  template<typename T>
+  inline void do_not_optimize(T const & value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile auto sink = value;
+    sink = value;
+#endif
+  }
+
+  inline void clobber_memory()
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+  }
+
+  /** Runs 'fn' (which performs 'operations' operations per call) 'repetitions' times and
+   * returns the median time per operation in nanoseconds.
+   */
+  template<typename Fn>
+  double measure(Fn && fn, std::size_t operations, std::size_t repetitions = 7)
+  {
+    using clock = std::chrono::steady_clock;
+
+    fn();
+
+    auto samples = std::vector<double>();
+    for(std::size_t i = 0; i < repetitions; ++i) {
+      auto const start = clock::now();
+      fn();
+      auto const elapsed = std::chrono::duration<double, std::nano>(clock::now() - start);
+      samples.push_back(elapsed.count() / static_cast<double>(operations));
+    }
+
+    std::ranges::nth_element(samples, samples.begin() + samples.size() / 2);
+    return samples[samples.size() / 2];
+  }
+
+  inline void report(char const * group, char const * name, double nanoseconds)
+  {
+    std::printf("%-32s %-40s %12.2f ns/op\n", group, name, nanoseconds);
+  }
+
+  inline void report(char const * group, char const * name, double nanoseconds,
+                     std::size_t code_bytes)
+  {
+    std::printf("%-32s %-40s %12.2f ns/op %8zu bytes\n", group, name, nanoseconds, code_bytes);
+  }
+
+  /** Size in bytes of the function starting at 'address', read from the symbol table of the
+   * running executable. Returns 0 when it is unknown (stripped binary, non-ELF platform).
+   */
+  inline std::size_t code_size(void const * address)
+  {
+#if defined(__linux__)
+    // {address, size} of every function symbol, relocated by the executable load address.
+    static auto const functions = [] {
+      auto result = std::vector<std::pair<std::uintptr_t, std::size_t>>();
+
+      auto file = std::ifstream("/proc/self/exe", std::ios::binary);
+      auto const image =
+          std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      if(image.size() < sizeof(Elf64_Ehdr))
+        return result;
+
+      auto header = Elf64_Ehdr();
+      std::memcpy(&header, image.data(), sizeof(header));
+      if(std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64)
+        return result;
+
+      auto bias = std::uintptr_t(0);
+      dl_iterate_phdr(
+          [](dl_phdr_info * info, std::size_t, void * out) {
+            *static_cast<std::uintptr_t *>(out) = info->dlpi_addr;
+            return 1; // the first object is the executable
+          },
+          &bias);
+
+      for(std::size_t i = 0; i < header.e_shnum; ++i) {
+        auto section = Elf64_Shdr();
+        std::memcpy(&section, image.data() + header.e_shoff + i * sizeof(section), sizeof(section));
+        if(section.sh_type != SHT_SYMTAB)
+          continue;
+
+        for(std::size_t j = 0; j < section.sh_size / sizeof(Elf64_Sym); ++j) {
+          auto symbol = Elf64_Sym();
+          std::memcpy(&symbol, image.data() + section.sh_offset + j * sizeof(symbol),
+                      sizeof(symbol));
+          if(ELF64_ST_TYPE(symbol.st_info) == STT_FUNC && symbol.st_value != 0)
+            result.emplace_back(bias + symbol.st_value, symbol.st_size);
+        }
+      }
+      return result;
+    }();
+
+    auto const key = reinterpret_cast<std::uintptr_t>(address);
+    for(auto const & [start, size] : functions)
+      if(start == key)
+        return size;
+#else
+    static_cast<void>(address);
+#endif
+    return 0;
+  }
+
+} // namespace benchmark
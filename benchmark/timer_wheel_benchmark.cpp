@@ -0,0 +1,98 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include <ruby/invocable_traits/timer_wheel.hpp>
+
+#include "./harness.hpp"
+
+namespace
+{
+  constexpr std::size_t timers = 200'000;
+  constexpr std::uint64_t max_delay = 1 << 16;
+
+  /** A session timeout: the session pointer and some context, 40 bytes of captures. */
+  struct timeout
+  {
+    std::uint64_t * expired;
+    std::array<std::uint64_t, 4> context;
+
+    void operator()() const
+    {
+      *expired += context[0];
+    }
+  };
+
+  struct queued
+  {
+    std::uint64_t deadline;
+    std::size_t index;
+    std::function<void()> callback;
+
+    friend bool operator<(queued const & x, queued const & y) noexcept
+    {
+      return x.deadline > y.deadline;
+    }
+  };
+
+  /** The baseline: a binary heap of std::function, cancelled entries skipped when popped. */
+  void run_priority_queue(std::vector<std::uint64_t> const & delays, std::uint64_t & expired)
+  {
+    auto queue = std::priority_queue<queued>();
+    auto cancelled = std::vector<bool>(delays.size());
+    for(std::size_t i = 0; i < delays.size(); ++i)
+      queue.push({delays[i], i, timeout {&expired, {1, 2, 3, 4}}});
+    for(std::size_t i = 0; i < delays.size(); i += 4)
+      cancelled[i] = true;
+
+    for(std::uint64_t now = 0; now <= max_delay; now += 64) {
+      while(!queue.empty() && queue.top().deadline <= now) {
+        auto entry = std::move(const_cast<queued &>(queue.top()));
+        queue.pop();
+        if(!cancelled[entry.index])
+          entry.callback();
+      }
+    }
+  }
+
+  void run_timer_wheel(std::vector<std::uint64_t> const & delays, std::uint64_t & expired)
+  {
+    auto wheel = ruby::inv::timer_wheel(delays.size());
+    auto ids = std::vector<ruby::inv::timer_id>(delays.size());
+    for(std::size_t i = 0; i < delays.size(); ++i)
+      ids[i] = wheel.schedule(delays[i], timeout {&expired, {1, 2, 3, 4}});
+    for(std::size_t i = 0; i < delays.size(); i += 4)
+      wheel.cancel(ids[i]);
+
+    for(std::uint64_t now = 0; now <= max_delay; now += 64)
+      wheel.advance_to(now);
+  }
+} // namespace
+
+int main()
+{
+  auto engine = std::mt19937_64(7);
+  auto distribution = std::uniform_int_distribution<std::uint64_t>(1, max_delay);
+  auto delays = std::vector<std::uint64_t>(timers);
+  for(auto & delay : delays)
+    delay = distribution(engine);
+
+  std::uint64_t expired = 0;
+  benchmark::report("200k timeouts, 1/4 cancelled", "std::priority_queue<std::function>",
+                    benchmark::measure(
+                        [&] {
+                          run_priority_queue(delays, expired);
+                          benchmark::do_not_optimize(expired);
+                        },
+                        timers));
+  benchmark::report("200k timeouts, 1/4 cancelled", "timer_wheel",
+                    benchmark::measure(
+                        [&] {
+                          run_timer_wheel(delays, expired);
+                          benchmark::do_not_optimize(expired);
+                        },
+                        timers));
+}
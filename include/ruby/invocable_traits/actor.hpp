@@ -0,0 +1,129 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+#include "./ring_buffer.hpp"
+#include "./wait_strategy.hpp"
+
+namespace ruby::inv
+{
+  namespace invocable_impl
+  {
+    /** Invokes 'fn' with the elements of 'args', passed as lvalues where 'fn' takes lvalue
+     * references and as rvalues otherwise.
+     */
+    template<typename Fn, typename Tuple, std::size_t... I>
+    decltype(auto) apply_stored(Fn & fn, Tuple & args, std::index_sequence<I...>)
+    {
+      return fn(std::forward<std::conditional_t<
+                    std::is_lvalue_reference_v<invocable_arg_t<Fn, I>>,
+                    std::tuple_element_t<I, Tuple> &,
+                    std::tuple_element_t<I, Tuple>>>(std::get<I>(args))...);
+    }
+
+    template<typename Fn, typename Tuple>
+    decltype(auto) apply_stored(Fn & fn, Tuple & args)
+    {
+      return apply_stored(fn, args, std::make_index_sequence<std::tuple_size_v<Tuple>>());
+    }
+  } // namespace invocable_impl
+
+  /** Default number of messages handled by actor::process before it returns. */
+  inline constexpr std::size_t actor_batch_size = 64;
+
+  /**
+   * A handler with a bounded mailbox of its decayed argument types.
+   * Messages are posted from other threads with post(args...), and handled in order by the one
+   * thread calling process() or run(). 'Mailbox' is spsc_ring for a single posting thread, or
+   * mpsc_ring for any number of them, and 'Wait' is the strategy used by full senders and by an
+   * idle run().
+   */
+  template<typename F, template<typename, typename> typename Mailbox = mpsc_ring,
+           typename Wait = futex_wait>
+    requires std::is_object_v<F> && invoke_deducible<F>
+  class actor
+  {
+  public:
+    using handler_type = F;
+    using message_type = invocable_decayed_args_t<F>;
+    using mailbox_type = Mailbox<message_type, Wait>;
+
+  private:
+    F m_handler;
+    mailbox_type m_mailbox;
+
+  public:
+    actor(F handler, std::size_t capacity)
+      : m_handler(std::move(handler))
+      , m_mailbox(capacity)
+    {}
+
+    /** Sends a message, waiting while the mailbox is full. */
+    template<typename... Args>
+      requires std::constructible_from<message_type, Args...>
+    void post(Args &&... args)
+    {
+      m_mailbox.emplace(std::forward<Args>(args)...);
+    }
+
+    /** Sends a message if the mailbox is not full. */
+    template<typename... Args>
+      requires std::constructible_from<message_type, Args...>
+    bool try_post(Args &&... args)
+    {
+      return m_mailbox.try_emplace(std::forward<Args>(args)...);
+    }
+
+    /** Handles up to 'max_batch' pending messages and returns their number. Never blocks. */
+    std::size_t process(std::size_t max_batch = actor_batch_size)
+    {
+      return m_mailbox.drain(
+          [this](message_type && message) { invocable_impl::apply_stored(m_handler, message); },
+          max_batch);
+    }
+
+    /** Handles messages as they arrive until a stop is requested on 'stop', then handles the
+     * messages posted before the stop request.
+     */
+    void run(std::stop_token stop)
+    {
+      auto wake = std::stop_callback(stop, [this] { m_mailbox.wake_consumer(); });
+      while(!stop.stop_requested()) {
+        if(process() == 0)
+          m_mailbox.wait_not_empty([&] { return stop.stop_requested(); });
+      }
+      while(process() != 0) {
+      }
+    }
+
+    F & handler() noexcept
+    {
+      return m_handler;
+    }
+
+    F const & handler() const noexcept
+    {
+      return m_handler;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+      return m_mailbox.capacity();
+    }
+  };
+
+  /** An actor posted to from a single thread. */
+  template<typename F, typename Wait = futex_wait>
+  using spsc_actor = actor<F, spsc_ring, Wait>;
+
+  /** An actor posted to from any number of threads. */
+  template<typename F, typename Wait = futex_wait>
+  using mpsc_actor = actor<F, mpsc_ring, Wait>;
+
+} // namespace ruby::inv
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  /**
+   * Converts a dynamically typed 'Value' into an argument of type 'T'.
+   * The primary template passes a 'Value' through, reads the alternative 'T' of a std::variant,
+   * and otherwise converts implicitly. Specialize it for the value type of a binding layer.
+   */
+  template<typename T, typename Value>
+  struct value_converter
+  {
+    static decltype(auto) convert(Value const & value)
+      requires std::same_as<T, Value> || std::convertible_to<Value const &, T> ||
+               requires { std::get<T>(value); }
+    {
+      if constexpr(std::same_as<T, Value>)
+        return (value);
+      else if constexpr(std::convertible_to<Value const &, T>)
+        return static_cast<T>(value);
+      else
+        return std::get<T>(value);
+    }
+  };
+
+  namespace invocable_impl
+  {
+    template<typename Arg, typename Value>
+    using argument_converter = value_converter<std::remove_cvref_t<Arg>, Value>;
+
+    template<typename Arg, typename Value>
+    concept convertible_argument = requires(Value const & value)
+    {
+      {
+        argument_converter<Arg, Value>::convert(value)
+        } -> std::convertible_to<Arg>;
+    };
+
+    template<typename F, typename Value, std::size_t... I>
+    constexpr bool convertible_arguments(std::index_sequence<I...>)
+    {
+      return (convertible_argument<invocable_arg_t<F, I>, Value> && ...);
+    }
+
+    template<typename F, typename Value, std::size_t... I>
+    decltype(auto) apply_converted(F && fn, [[maybe_unused]] Value const * values,
+                                   std::index_sequence<I...>)
+    {
+      using target = std::remove_cvref_t<F>;
+      return std::invoke(std::forward<F>(fn),
+                         static_cast<invocable_arg_t<target, I>>(
+                             argument_converter<invocable_arg_t<target, I>, Value>::convert(
+                                 values[I]))...);
+    }
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** 'F' has a fixed number of parameters, each of which can be produced from a 'Value'. */
+  template<typename F, typename Value>
+  concept applicable_from =
+    invoke_deducible<std::remove_cvref_t<F>> &&
+    !std::is_member_pointer_v<std::remove_cvref_t<F>> &&
+    !invocable_is_variadic_v<std::remove_cvref_t<F>> &&
+    invocable_impl::convertible_arguments<std::remove_cvref_t<F>, Value>(
+      std::make_index_sequence<invocable_arity_v<std::remove_cvref_t<F>>>());
+
+  // clang-format on
+
+  /** Thrown by apply_from when the number of values differs from the arity of the callable. */
+  class arity_mismatch : public std::invalid_argument
+  {
+    std::size_t m_expected;
+    std::size_t m_actual;
+
+  public:
+    arity_mismatch(std::size_t expected, std::size_t actual)
+      : std::invalid_argument("apply_from: expected " + std::to_string(expected) +
+                              " arguments, got " + std::to_string(actual))
+      , m_expected(expected)
+      , m_actual(actual)
+    {}
+
+    std::size_t expected() const noexcept
+    {
+      return m_expected;
+    }
+
+    std::size_t actual() const noexcept
+    {
+      return m_actual;
+    }
+  };
+
+  /**
+   * Invokes 'fn' with the first invocable_arity_v<F> values of 'values', each converted to the
+   * corresponding parameter type through value_converter. The count is not checked.
+   * The converted values are passed straight to the call, without an intermediate std::tuple.
+   */
+  template<typename F, typename Value>
+    requires applicable_from<F, Value>
+  decltype(auto) apply_from_buffer(F && fn, Value const * values)
+  {
+    using target = std::remove_cvref_t<F>;
+    return invocable_impl::apply_converted(std::forward<F>(fn), values,
+                                           std::make_index_sequence<invocable_arity_v<target>>());
+  }
+
+  /** Like apply_from_buffer, after checking once that 'values' holds exactly one value per
+   * parameter of 'fn'. Throws arity_mismatch otherwise.
+   */
+  template<typename F, typename Value>
+    requires applicable_from<F, Value>
+  decltype(auto) apply_from(F && fn, std::span<Value const> values)
+  {
+    constexpr auto arity = invocable_arity_v<std::remove_cvref_t<F>>;
+    if(values.size() != arity)
+      throw arity_mismatch(arity, values.size());
+    return apply_from_buffer(std::forward<F>(fn), values.data());
+  }
+
+  /** apply_from over the elements of a contiguous range. */
+  template<typename F, std::ranges::contiguous_range Range>
+    requires std::ranges::sized_range<Range> &&
+             applicable_from<F, std::ranges::range_value_t<Range>>
+  decltype(auto) apply_from(F && fn, Range const & values)
+  {
+    using value_type = std::ranges::range_value_t<Range>;
+    return apply_from(std::forward<F>(fn), std::span<value_type const>(values));
+  }
+
+} // namespace ruby::inv
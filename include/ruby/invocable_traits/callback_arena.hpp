@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  /** Default size of the block a callback_arena allocates up front. */
+  inline constexpr std::size_t callback_arena_initial_capacity = 4096;
+
+  template<typename Signature>
+  class callback_arena;
+
+  namespace invocable_impl
+  {
+    /** Forwards to another resource, counting the bytes allocated through it. */
+    class counting_resource : public std::pmr::memory_resource
+    {
+      std::pmr::memory_resource * m_upstream;
+      std::size_t m_allocated = 0;
+
+      void * do_allocate(std::size_t bytes, std::size_t alignment) override
+      {
+        auto * memory = m_upstream->allocate(bytes, alignment);
+        m_allocated += bytes;
+        return memory;
+      }
+
+      void do_deallocate(void * memory, std::size_t bytes, std::size_t alignment) override
+      {
+        m_upstream->deallocate(memory, bytes, alignment);
+      }
+
+      bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override
+      {
+        return this == &other;
+      }
+
+    public:
+      explicit counting_resource(std::pmr::memory_resource * upstream) noexcept
+        : m_upstream(upstream)
+      {}
+
+      std::size_t reset_allocated() noexcept
+      {
+        return std::exchange(m_allocated, 0);
+      }
+    };
+  } // namespace invocable_impl
+
+  /**
+   * Stores callables whose normalized signature (invocable_signature_t) is 'R(Args...)' in a
+   * monotonic arena. Each insertion is one bump allocation, invoke() calls them in insertion
+   * order, and reset() destroys them all and rewinds the arena at once.
+   * The arena keeps its first block across resets and grows it to the high-water mark, so a
+   * steady per-frame workload stops allocating from the upstream resource.
+   * Callables that use a std::pmr::polymorphic_allocator are constructed with one drawing from
+   * the arena, so their own allocations are released by reset() as well.
+   */
+  template<typename R, typename... Args>
+  class callback_arena<R(Args...)>
+  {
+    static_assert((!std::is_rvalue_reference_v<Args> && ...),
+                  "every callback receives the same arguments, they cannot be rvalue references");
+
+    struct node
+    {
+      node * next;
+      R (*invoke)(node *, Args &...);
+      void (*destroy)(node *) noexcept;
+    };
+
+    template<typename F>
+    struct block : node
+    {
+      F fn;
+
+      static R invoke_block(node * self, Args &... args)
+      {
+        return std::invoke(static_cast<block *>(self)->fn, args...);
+      }
+
+      static void destroy_block(node * self) noexcept
+      {
+        std::destroy_at(static_cast<block *>(self));
+      }
+    };
+
+    std::pmr::memory_resource * m_upstream;
+    invocable_impl::counting_resource m_overflow;
+    std::size_t m_capacity;
+    void * m_buffer;
+    std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+
+    node * m_first = nullptr;
+    node * m_last = nullptr;
+    std::size_t m_size = 0;
+
+    void destroy_all() noexcept
+    {
+      for(auto * current = m_first; current; current = current->next)
+        if(current->destroy)
+          current->destroy(current);
+      m_first = m_last = nullptr;
+      m_size = 0;
+    }
+
+  public:
+    using signature_type = R(Args...);
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    explicit callback_arena(std::size_t initial_capacity = callback_arena_initial_capacity,
+                            std::pmr::memory_resource * upstream = std::pmr::get_default_resource())
+      : m_upstream(upstream)
+      , m_overflow(upstream)
+      , m_capacity(std::max<std::size_t>(initial_capacity, sizeof(block<void (*)()>)))
+      , m_buffer(m_upstream->allocate(m_capacity, alignof(std::max_align_t)))
+    {
+      m_arena.emplace(m_buffer, m_capacity, &m_overflow);
+    }
+
+    callback_arena(callback_arena const &) = delete;
+    callback_arena & operator=(callback_arena const &) = delete;
+
+    ~callback_arena()
+    {
+      destroy_all();
+      m_arena.reset();
+      m_upstream->deallocate(m_buffer, m_capacity, alignof(std::max_align_t));
+    }
+
+    /** Constructs a copy of 'fn' in the arena. The normalized signature of 'F' must be exactly
+     * the signature of the arena.
+     */
+    template<typename F>
+      requires invoke_deducible<std::decay_t<F>> &&
+               std::same_as<invocable_signature_t<std::decay_t<F>>, R(Args...)>
+    void push(F && fn)
+    {
+      using T = std::decay_t<F>;
+      using block_type = block<T>;
+
+      auto * memory = m_arena->allocate(sizeof(block_type), alignof(block_type));
+      auto * self = [&] {
+        auto const header = node {
+            nullptr,
+            &block_type::invoke_block,
+            std::is_trivially_destructible_v<T> ? nullptr : &block_type::destroy_block};
+        if constexpr(std::uses_allocator_v<T, allocator_type>)
+          return ::new(memory) block_type {
+              header, std::make_obj_using_allocator<T>(get_allocator(), std::forward<F>(fn))};
+        else
+          return ::new(memory) block_type {header, T(std::forward<F>(fn))};
+      }();
+
+      (m_last ? m_last->next : m_first) = self;
+      m_last = self;
+      ++m_size;
+    }
+
+    /** Invokes every callback, in insertion order, with the same arguments. */
+    void invoke(Args... args)
+    {
+      for(auto * current = m_first; current; current = current->next)
+        current->invoke(current, args...);
+    }
+
+    /** Destroys every callback and releases the arena memory in one step. */
+    void reset() noexcept
+    {
+      destroy_all();
+      m_arena->release();
+
+      auto const overflow = m_overflow.reset_allocated();
+      if(overflow == 0)
+        return;
+
+      // Grow the first block so that the next cycle fits without upstream allocations.
+      auto const capacity = std::bit_ceil(m_capacity + overflow);
+      void * buffer = nullptr;
+      try {
+        buffer = m_upstream->allocate(capacity, alignof(std::max_align_t));
+      } catch(std::bad_alloc const &) {
+        return;
+      }
+
+      m_arena.reset();
+      m_upstream->deallocate(m_buffer, m_capacity, alignof(std::max_align_t));
+      m_buffer = buffer;
+      m_capacity = capacity;
+      m_arena.emplace(m_buffer, m_capacity, &m_overflow);
+    }
+
+    std::size_t size() const noexcept
+    {
+      return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+    /** Size of the block reused across resets. */
+    std::size_t capacity() const noexcept
+    {
+      return m_capacity;
+    }
+
+    /** Allocator drawing from the arena, valid until the next reset(). */
+    allocator_type get_allocator() noexcept
+    {
+      return allocator_type(std::addressof(*m_arena));
+    }
+
+    std::pmr::memory_resource * resource() noexcept
+    {
+      return std::addressof(*m_arena);
+    }
+  };
+
+} // namespace ruby::inv
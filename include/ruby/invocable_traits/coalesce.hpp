@@ -0,0 +1,184 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  namespace invocable_impl
+  {
+    /** The type of the items a batch handler 'H' receives: the value type of its first argument. */
+    template<typename H>
+    using batch_item_t = std::ranges::range_value_t<std::remove_cvref_t<invocable_arg_t<H, 0>>>;
+
+    /** Destroys the buffered items and empties the buffer, even if the handler threw. */
+    template<typename T>
+    struct batch_guard
+    {
+      T * items;
+      std::size_t & size;
+
+      ~batch_guard()
+      {
+        std::destroy_n(items, std::exchange(size, 0));
+      }
+    };
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** A callable taking one batch of items: a deducible callable of one argument, a range of
+   * items it can be called with as a std::span over them.
+   */
+  template<typename H>
+  concept batch_handler =
+    std::is_object_v<H> &&
+    invoke_deducible<H> &&
+    !std::is_member_pointer_v<H> &&
+    (invocable_arity_v<H> == 1) &&
+    !invocable_is_variadic_v<H> &&
+    std::ranges::range<std::remove_cvref_t<invocable_arg_t<H, 0>>> &&
+    std::is_object_v<invocable_impl::batch_item_t<H>> &&
+    std::invocable<H &, std::span<invocable_impl::batch_item_t<H>>>;
+
+  // clang-format on
+
+  /**
+   * Turns calls with one item into calls of 'H' with a batch of them.
+   * Calling a coalescer with an item moves it into a buffer allocated once, of capacity()
+   * items; the buffer is passed to the handler as one contiguous std::span when it is full,
+   * when flush() is called, or on the first call or poll() once its oldest item has waited
+   * 'max_delay' on 'Clock'. The handler may consume the items, they are destroyed after the
+   * call even if it throws. Whatever is buffered is flushed on destruction, where exceptions
+   * from the handler are discarded.
+   * A coalescer is not thread safe, and the handler must not call it back.
+   */
+  template<batch_handler H, typename Clock = std::chrono::steady_clock>
+  class coalescer
+  {
+  public:
+    using item_type = invocable_impl::batch_item_t<H>;
+    using clock = Clock;
+    using duration = typename Clock::duration;
+
+  private:
+    struct deallocate
+    {
+      std::size_t capacity;
+
+      void operator()(item_type * items) const noexcept
+      {
+        std::allocator<item_type>().deallocate(items, capacity);
+      }
+    };
+
+    [[no_unique_address]] H m_handler;
+    std::unique_ptr<item_type, deallocate> m_items;
+    std::size_t m_size = 0;
+    duration m_max_delay;
+    typename Clock::time_point m_oldest {};
+
+    bool due(typename Clock::time_point now) const
+    {
+      return m_size != 0 && now - m_oldest >= m_max_delay;
+    }
+
+  public:
+    /** Creates a coalescer flushing batches of up to 'capacity' items, at least one, to
+     * 'handler', and flushing any item that waited 'max_delay'.
+     */
+    coalescer(H handler, std::size_t capacity, duration max_delay = duration::max())
+      : m_handler(std::move(handler))
+      , m_items(std::allocator<item_type>().allocate(capacity == 0 ? 1 : capacity),
+                deallocate {capacity == 0 ? 1 : capacity})
+      , m_max_delay(max_delay)
+    {}
+
+    coalescer(coalescer && other) noexcept(std::is_nothrow_move_constructible_v<H>)
+      : m_handler(std::move(other.m_handler))
+      , m_items(std::move(other.m_items))
+      , m_size(std::exchange(other.m_size, 0))
+      , m_max_delay(other.m_max_delay)
+      , m_oldest(other.m_oldest)
+    {}
+
+    coalescer & operator=(coalescer &&) = delete;
+
+    /** Flushes the buffered items, discarding any exception thrown by the handler; call flush()
+     * beforehand to observe it.
+     */
+    ~coalescer()
+    {
+      if(!m_items)
+        return;
+      try {
+        flush();
+      } catch(...) {
+      }
+    }
+
+    std::size_t capacity() const noexcept
+    {
+      return m_items.get_deleter().capacity;
+    }
+
+    /** Number of buffered items. */
+    std::size_t size() const noexcept
+    {
+      return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+    /** Buffers 'item', then flushes if the buffer is full or its oldest item is due. */
+    void operator()(item_type item)
+    {
+      auto const now = Clock::now();
+      std::construct_at(m_items.get() + m_size, std::move(item));
+      if(m_size++ == 0)
+        m_oldest = now;
+      if(m_size == capacity() || due(now))
+        flush();
+    }
+
+    /** Passes the buffered items, if any, to the handler. */
+    void flush()
+    {
+      if(m_size == 0)
+        return;
+      auto guard = invocable_impl::batch_guard<item_type> {m_items.get(), m_size};
+      std::invoke(m_handler, std::span<item_type>(m_items.get(), m_size));
+    }
+
+    /** Flushes if the oldest buffered item has waited 'max_delay'. Returns true if it did. */
+    bool poll()
+    {
+      if(!due(Clock::now()))
+        return false;
+      flush();
+      return true;
+    }
+  };
+
+  /** The coalescer of 'handler', see coalescer. */
+  template<typename Clock = std::chrono::steady_clock, typename H>
+    requires batch_handler<std::decay_t<H>>
+  auto coalesce(H && handler, std::size_t capacity,
+                typename Clock::duration max_delay = Clock::duration::max())
+  {
+    return coalescer<std::decay_t<H>, Clock>(std::forward<H>(handler), capacity, max_delay);
+  }
+
+} // namespace ruby::inv
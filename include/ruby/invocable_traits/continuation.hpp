@@ -0,0 +1,147 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  template<typename... Stages>
+  class chain;
+
+  namespace invocable_impl
+  {
+    template<typename G, typename Input>
+    inline constexpr bool accepts_input_v =
+        invocable_arity_v<G> == 1 && std::invocable<G &, Input>;
+
+    template<typename G>
+    inline constexpr bool accepts_input_v<G, void> =
+        invocable_arity_v<G> == 0 && std::invocable<G &>;
+
+    /** Gives chain the call operator 'R(Args...)' of its first stage, so that a chain is itself
+     * invoke_deducible.
+     */
+    template<typename Derived, typename R, typename Args>
+    struct chain_call;
+
+    template<typename Derived, typename R, typename... Args>
+    struct chain_call<Derived, R, std::tuple<Args...>>
+    {
+      R operator()(Args... args)
+      {
+        return static_cast<Derived &>(*this).template run<0>(std::forward<Args>(args)...);
+      }
+    };
+
+    template<typename... Stages>
+    using first_stage_t = std::tuple_element_t<0, std::tuple<Stages...>>;
+
+    template<typename... Stages>
+    using chain_result_t =
+        invocable_ret_t<std::tuple_element_t<sizeof...(Stages) - 1, std::tuple<Stages...>>>;
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** A stage that can be started from: a deducible callable that is not variadic. */
+  template<typename F>
+  concept chain_stage =
+    std::is_object_v<F> &&
+    invoke_deducible<F> &&
+    !invocable_is_variadic_v<F>;
+
+  /** 'G' can follow a stage returning 'Input': it takes exactly one argument it can be called
+   * with, or none when 'Input' is void.
+   */
+  template<typename G, typename Input>
+  concept continuation_of =
+    chain_stage<G> &&
+    invocable_impl::accepts_input_v<G, Input>;
+
+  // clang-format on
+
+  /**
+   * A statically typed continuation chain: calling it calls the first stage with the arguments,
+   * then every following stage with the result of the previous one, moved along.
+   * The stages are stored by value in the chain, so building and running it allocates nothing
+   * and shares no state; its call operator has the arguments of the first stage and the result
+   * of the last one, so a chain is invoke_deducible and can be submitted to an executor as one
+   * task.
+   */
+  template<typename... Stages>
+  class chain
+    : public invocable_impl::chain_call<chain<Stages...>,
+                                        invocable_impl::chain_result_t<Stages...>,
+                                        invocable_args_t<invocable_impl::first_stage_t<Stages...>>>
+  {
+    template<typename...>
+    friend class chain;
+
+    template<typename, typename, typename>
+    friend struct invocable_impl::chain_call;
+
+    std::tuple<Stages...> m_stages;
+
+    template<std::size_t I>
+    using result_t = invocable_ret_t<std::tuple_element_t<I, std::tuple<Stages...>>>;
+
+    template<std::size_t I, typename... In>
+    decltype(auto) run(In &&... in)
+    {
+      auto & stage = std::get<I>(m_stages);
+      if constexpr(I + 1 == sizeof...(Stages)) {
+        return std::invoke(stage, std::forward<In>(in)...);
+      } else if constexpr(std::is_void_v<result_t<I>>) {
+        std::invoke(stage, std::forward<In>(in)...);
+        return run<I + 1>();
+      } else {
+        return run<I + 1>(std::invoke(stage, std::forward<In>(in)...));
+      }
+    }
+
+    chain(std::in_place_t, std::tuple<Stages...> && stages)
+      : m_stages(std::move(stages))
+    {}
+
+  public:
+    static constexpr std::size_t stage_count = sizeof...(Stages);
+
+    explicit chain(Stages... stages)
+      : m_stages(std::move(stages)...)
+    {}
+
+    /** Appends 'next', which takes the result of the last stage. */
+    template<typename G>
+      requires continuation_of<std::decay_t<G>, invocable_impl::chain_result_t<Stages...>>
+    auto then(G && next) &&
+    {
+      return chain<Stages..., std::decay_t<G>>(
+          std::in_place,
+          std::tuple_cat(std::move(m_stages), std::tuple<std::decay_t<G>>(std::forward<G>(next))));
+    }
+
+    template<typename G>
+      requires continuation_of<std::decay_t<G>, invocable_impl::chain_result_t<Stages...>>
+    auto then(G && next) const &
+    {
+      return chain<Stages..., std::decay_t<G>>(
+          std::in_place,
+          std::tuple_cat(m_stages, std::tuple<std::decay_t<G>>(std::forward<G>(next))));
+    }
+  };
+
+  /** The chain made of the single stage 'fn'; see chain::then. */
+  template<typename F>
+    requires chain_stage<std::decay_t<F>>
+  auto start(F && fn)
+  {
+    return chain<std::decay_t<F>>(std::forward<F>(fn));
+  }
+
+} // namespace ruby::inv
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  namespace invocable_impl
+  {
+    /** Fields stored in declaration order, empty ones taking no space. */
+    template<typename... Ts>
+    struct packed_fields
+    {
+      constexpr explicit packed_fields(std::in_place_t) noexcept
+      {}
+    };
+
+    template<typename T, typename... Ts>
+    struct packed_fields<T, Ts...>
+    {
+      [[no_unique_address]] T head;
+      [[no_unique_address]] packed_fields<Ts...> tail;
+
+      template<typename U, typename... Us>
+      constexpr explicit packed_fields(std::in_place_t, U && value, Us &&... values)
+        : head(std::forward<U>(value))
+        , tail(std::in_place, std::forward<Us>(values)...)
+      {}
+    };
+
+    template<std::size_t I, typename Fields>
+    constexpr auto & packed_get(Fields & fields) noexcept
+    {
+      if constexpr(I == 0)
+        return fields.head;
+      else
+        return packed_get<I - 1>(fields.tail);
+    }
+
+    /** Indices of 'Ts' by decreasing alignment, equal alignments keeping their order. */
+    template<typename... Ts>
+    constexpr auto alignment_order() noexcept
+    {
+      constexpr auto alignments = std::array<std::size_t, sizeof...(Ts)> {alignof(Ts)...};
+      auto order = std::array<std::size_t, sizeof...(Ts)> {};
+      for(std::size_t i = 0; i < order.size(); ++i) {
+        auto j = i;
+        for(; j > 0 && alignments[order[j - 1]] < alignments[i]; --j)
+          order[j] = order[j - 1];
+        order[j] = i;
+      }
+      return order;
+    }
+
+    template<typename Order>
+    constexpr auto inverse_order(Order const & order) noexcept
+    {
+      auto position = Order {};
+      for(std::size_t i = 0; i < order.size(); ++i)
+        position[order[i]] = i;
+      return position;
+    }
+
+    template<typename List, typename Sequence>
+    struct aligned_fields;
+
+    /** packed_fields of 'Ts' by decreasing alignment, addressed by the original indices. */
+    template<typename... Ts, std::size_t... I>
+    struct aligned_fields<std::tuple<Ts...>, std::index_sequence<I...>>
+    {
+      static constexpr auto order = alignment_order<Ts...>();
+      static constexpr auto position = inverse_order(order);
+
+      using type = packed_fields<std::tuple_element_t<order[I], std::tuple<Ts...>>...>;
+
+      /** Constructs the fields from 'values', given in the original order. */
+      template<typename... Us>
+      static constexpr type make(Us &&... values)
+      {
+        auto references = std::forward_as_tuple(std::forward<Us>(values)...);
+        return type(std::in_place, std::get<order[I]>(std::move(references))...);
+      }
+
+      template<std::size_t J, typename Fields>
+      static constexpr auto & get(Fields & fields) noexcept
+      {
+        return packed_get<position[J]>(fields);
+      }
+    };
+
+    template<typename F, typename Args>
+    struct deferred_layout;
+
+    template<typename F, typename... Args>
+    struct deferred_layout<F, std::tuple<Args...>>
+      : aligned_fields<std::tuple<F, Args...>, std::index_sequence_for<F, Args...>>
+    {};
+  } // namespace invocable_impl
+
+  /**
+   * A callable captured together with its arguments, stored as the decayed parameter types of
+   * 'F' (invocable_decayed_args_t), for a later call.
+   * The callable and the arguments are laid out by decreasing alignment, which removes the
+   * padding between fields that a std::tuple in declaration order pays, and the parameter order
+   * is restored when the call is made.
+   */
+  template<typename F>
+    requires std::is_object_v<F> && invoke_deducible<F> && (!std::is_member_pointer_v<F>)
+  class deferred_call
+  {
+    using arguments = invocable_decayed_args_t<F>;
+    using layout = invocable_impl::deferred_layout<F, arguments>;
+
+    typename layout::type m_fields;
+
+    template<std::size_t... I>
+    constexpr decltype(auto) call(std::index_sequence<I...>)
+    {
+      return std::invoke(
+          layout::template get<0>(m_fields),
+          std::forward<std::conditional_t<
+              std::is_lvalue_reference_v<invocable_arg_t<F, I>>,
+              std::tuple_element_t<I, arguments> &,
+              std::tuple_element_t<I, arguments>>>(layout::template get<I + 1>(m_fields))...);
+    }
+
+  public:
+    using function_type = F;
+    using arguments_type = arguments;
+    using result_type = invocable_ret_t<F>;
+
+    template<typename... Args>
+      requires std::constructible_from<arguments, Args...>
+    constexpr explicit deferred_call(F fn, Args &&... args)
+      : m_fields(layout::make(std::move(fn), std::forward<Args>(args)...))
+    {}
+
+    /** Makes the call. Arguments are passed as lvalues to lvalue reference parameters and
+     * moved otherwise, so a deferred_call is meant to be called once.
+     */
+    constexpr result_type operator()()
+    {
+      return call(std::make_index_sequence<std::tuple_size_v<arguments>>());
+    }
+
+    /** The callable, for I == 0, or the argument for parameter I - 1. */
+    template<std::size_t I>
+    constexpr auto & get() noexcept
+    {
+      return layout::template get<I>(m_fields);
+    }
+
+    template<std::size_t I>
+    constexpr auto const & get() const noexcept
+    {
+      return layout::template get<I>(m_fields);
+    }
+  };
+
+  template<typename F, typename... Args>
+  deferred_call(F, Args...) -> deferred_call<F>;
+
+} // namespace ruby::inv
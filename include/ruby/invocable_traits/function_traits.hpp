@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -9,6 +12,66 @@ namespace ruby::inv
 
   // clang-format off
 
+  /**
+   * Define RUBY_INVOCABLE_TRAITS_STAGED_MATCHING to select the staged matching strategy.
+   * By default every function_traits specialization rebuilds its function type through
+   * make_function, and qualifiers are removed one at a time, each step a new partial match.
+   * In the staged strategy the qualifiers of a function type are encoded in a key, and
+   * function types are built by a full specialization of function_builder on that key, which
+   * needs no partial matching; function_traits shares one record of qualifiers per key and does
+   * not rebuild its function type, and the composite modifications, like
+   * function_remove_qualifiers_t, rebuild the function type in a single step.
+   */
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  namespace invocable_impl
+  {
+    constexpr unsigned qualifier_key(bool IsConst, bool IsVolatile, unsigned NumRef, bool IsVariadic)
+    {
+      return unsigned(IsConst) | unsigned(IsVolatile) << 1 | NumRef << 2 | unsigned(IsVariadic) << 4;
+    }
+
+    template<unsigned Key>
+    struct function_builder;
+
+    /** The qualifiers of a function type: one instantiation per combination, shared by every
+     * function_traits lookup.
+     */
+    template<unsigned Key, bool IsNoexcept>
+    struct function_qualifiers
+    {
+      static constexpr bool is_const = Key & 1;
+      static constexpr bool is_volatile = (Key >> 1) & 1;
+      static constexpr unsigned num_references = (Key >> 2) & 3;
+      static constexpr bool is_noexcept = IsNoexcept;
+      static constexpr bool is_variadic = (Key >> 4) & 1;
+    };
+
+    /** The return and argument types of the function type 'T', which is not rebuilt. */
+    template<typename T, typename Ret, typename... Args>
+    struct function_signature
+    {
+      using function_type = T;
+      using return_type = Ret;
+      using argument_types = std::tuple<Args...>;
+
+      static constexpr auto arity = sizeof...(Args);
+
+      template<std::size_t index>
+        requires(index < arity)
+      using argument = std::tuple_element_t<index, argument_types>;
+    };
+  }
+
+  template<
+    bool IsConst, bool IsVolatile, unsigned NumRef,
+    bool IsVariadic,  bool IsNoexcept, typename Ret, typename... Args>
+      requires (NumRef < 3)
+  struct make_function
+  {
+    using type = typename invocable_impl::function_builder<invocable_impl::qualifier_key(
+        IsConst, IsVolatile, NumRef, IsVariadic)>::template type<IsNoexcept, Ret, Args...>;
+  };
+#else
   /**
    * make_function builds a function types with the given qualifiers, return type and argument types.
    * The primarty template is not defined, because all cases are handled by the template specializations.
@@ -18,15 +81,25 @@ namespace ruby::inv
     bool IsVariadic,  bool IsNoexcept, typename Ret, typename... Args>
       requires (NumRef < 3)
   struct make_function;
+#endif
 
   /** Returns a function type with the given qualifiers, return type and argument types.
    */
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  template<
+    bool IsConst, bool IsVolatile,  unsigned NumRef, 
+    bool IsVariadic, bool IsNoexcept, typename Ret, typename... Args>
+      requires (NumRef < 3)
+  using make_function_t = typename invocable_impl::function_builder<invocable_impl::qualifier_key(
+      IsConst, IsVolatile, NumRef, IsVariadic)>::template type<IsNoexcept, Ret, Args...>;
+#else
   template<
     bool IsConst, bool IsVolatile,  unsigned NumRef, 
     bool IsVariadic, bool IsNoexcept, typename Ret, typename... Args>
       requires (NumRef < 3)
   using make_function_t = typename make_function<IsConst, IsVolatile, NumRef, IsVariadic,
                                                  IsNoexcept, Ret, Args...>::type;
+#endif
 
   template<bool IsConst, bool IsVolatile, unsigned NumRef, bool IsVariadic,
            bool IsNoexcept, typename Ret, typename... Args>
@@ -145,15 +218,56 @@ namespace ruby::inv
     struct function_modify<T> : function_modify<T, function_args_t<T>>
     {};
 
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+    /** Every modification rebuilds the function type in one step, from the qualifier key of 'T'
+     * and a full specialization of function_builder.
+     */
+    template<typename T, typename... Args>
+    struct function_modify<T, std::tuple<Args...>>
+    {
+  private:
+      using traits = function_traits<T>;
+
+      static constexpr auto key = qualifier_key(traits::is_const, traits::is_volatile,
+                                                traits::num_references, traits::is_variadic);
+      static constexpr auto IN = traits::is_noexcept;
+
+      template<unsigned Key, bool IsNoexcept>
+      using with = typename function_builder<Key>::template type<IsNoexcept,
+                                                                typename traits::return_type, Args...>;
+
+  public:
+      using add_const = with<key | 0b00001u, IN>;
+      using remove_const = with<key & ~0b00001u, IN>;
+
+      using add_volatile = with<key | 0b00010u, IN>;
+      using remove_volatile = with<key & ~0b00010u, IN>;
+
+      using add_variadic = with<key | 0b10000u, IN>;
+      using remove_variadic = with<key & ~0b10000u, IN>;
+
+      using add_noexcept = with<key, true>;
+      using remove_noexcept = with<key, false>;
+
+      using remove_lvalue_reference = with<key & ~0b00100u, IN>;
+      using remove_rvalue_reference = with<key & ~0b01000u, IN>;
+
+      using add_cv = with<key | 0b00011u, IN>;
+      using remove_cv = with<key & ~0b00011u, IN>;
+      using remove_reference = with<key & ~0b01100u, IN>;
+      using remove_cvref = with<key & 0b10000u, IN>;
+      using remove_qualifiers = with<key & 0b10000u, false>;
+    };
+#else
     template<typename T, typename... Args>
     struct function_modify<T, std::tuple<Args...>>
     {
   private:
-      static constexpr auto C = function_is_const_v<T>;
-      static constexpr auto V = function_is_volatile_v<T>;
+      static constexpr auto C = function_traits<T>::is_const;
+      static constexpr auto V = function_traits<T>::is_volatile;
       static constexpr auto R = function_traits<T>::num_references;
-      static constexpr auto IV = function_is_variadic_v<T>;
-      static constexpr auto IN = function_is_noexcept_v<T>;
+      static constexpr auto IV = function_traits<T>::is_variadic;
+      static constexpr auto IN = function_traits<T>::is_noexcept;
       using ret = function_ret_t<T>;
 
   public:
@@ -172,6 +286,7 @@ namespace ruby::inv
       using remove_lvalue_reference = make_function_t<C, V, R & 0b10, IV, IN, ret, Args...>;
       using remove_rvalue_reference = make_function_t<C, V, R & 0b01, IV, IN, ret, Args...>;
     };
+#endif
   } // namespace impl
 
   // clang-format off
@@ -194,11 +309,19 @@ namespace ruby::inv
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_add_cv_t = typename invocable_impl::function_modify<T>::add_cv;
+#else
   using function_add_cv_t = function_add_const_t<function_add_volatile_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_cv_t = typename invocable_impl::function_modify<T>::remove_cv;
+#else
   using function_remove_cv_t = function_remove_const_t<function_remove_volatile_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
@@ -228,19 +351,70 @@ namespace ruby::inv
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_reference_t = typename invocable_impl::function_modify<T>::remove_reference;
+#else
   using function_remove_reference_t =
       function_remove_lvalue_reference_t<function_remove_rvalue_reference_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_cvref_t = typename invocable_impl::function_modify<T>::remove_cvref;
+#else
   using function_remove_cvref_t = function_remove_cv_t<function_remove_reference_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_qualifiers_t = typename invocable_impl::function_modify<T>::remove_qualifiers;
+#else
   using function_remove_qualifiers_t = function_remove_cvref_t<function_remove_noexcept_t<T>>;
+#endif
 
   // clang-format on
 
+
+  /** Compact description of one function argument type, see function_arg_properties_v. */
+  struct arg_properties
+  {
+    std::uint32_t size;      // sizeof the referred object type, 0 if it is not an object type
+    std::uint16_t alignment; // alignof the referred object type, 0 if it is not an object type
+    bool is_reference : 1;
+    bool is_rvalue_reference : 1;
+    bool is_pointer : 1;
+    bool is_trivially_copyable : 1;
+    bool is_trivially_destructible : 1;
+
+    template<typename T>
+    static constexpr arg_properties of() noexcept
+    {
+      using U = std::remove_reference_t<T>;
+      auto properties = arg_properties{0, 0, std::is_reference_v<T>, std::is_rvalue_reference_v<T>,
+                                       std::is_pointer_v<U>, false, false};
+      if constexpr(std::is_object_v<U>){
+        static_assert(sizeof(U) <= std::numeric_limits<std::uint32_t>::max(),
+                      "the argument type is too large for arg_properties::size");
+        static_assert(alignof(U) <= std::numeric_limits<std::uint16_t>::max(),
+                      "the argument type is too aligned for arg_properties::alignment");
+        properties.size = sizeof(U);
+        properties.alignment = alignof(U);
+        properties.is_trivially_copyable = std::is_trivially_copyable_v<U>;
+        properties.is_trivially_destructible = std::is_trivially_destructible_v<U>;
+      }
+      return properties;
+    }
+  };
+
+  /** One arg_properties record per argument of the function type 'T', in order. */
+  template<typename T>
+    requires std::is_function_v<T>
+  inline constexpr auto function_arg_properties_v = []<typename... Args>(std::tuple<Args...> *) {
+    return std::array<arg_properties, sizeof...(Args)>{arg_properties::of<Args>()...};
+  }(static_cast<function_args_t<T> *>(nullptr));
+
 #define RUBY_ADD_CVREF_000
 #define RUBY_ADD_CVREF_010 volatile
 #define RUBY_ADD_CVREF_100 const
@@ -262,6 +436,25 @@ namespace ruby::inv
 #define RUBY_MAYBE_CVREF(X, Y, Z) RUBY_CONCAT4(RUBY_ADD_CVREF_, X, Y, Z)
 #define RUBY_MAYBE_VARIADIC(X) RUBY_CONCAT2(RUBY_VARIADIC_, X)
 
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+
+#define RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, Qual, Pack)                      \
+  template<>                                                                         \
+  struct invocable_impl::function_builder<invocable_impl::qualifier_key(C, V, R, IV)> \
+  {                                                                                  \
+    template<bool IN, typename Ret, typename... Args>                                \
+    using type = Ret(Args... Pack) Qual noexcept(IN);                                \
+  };
+
+#define RUBY_DEFINE_FUNCTION_TRAITS_IMPL(C, V, R, IV, Qual, Pack)                          \
+  template<bool IN, typename Ret, typename... Args>                                        \
+  struct function_traits<Ret(Args... Pack) Qual noexcept(IN)>                              \
+    : invocable_impl::function_qualifiers<invocable_impl::qualifier_key(C, V, R, IV), IN>  \
+    , invocable_impl::function_signature<Ret(Args... Pack) Qual noexcept(IN), Ret, Args...> \
+  {};
+
+#else
+
 #define RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, Qual, Pack) \
   template<bool IN, typename Ret, typename... Args>        \
   struct make_function<C, V, R, IV, IN, Ret, Args...>      \
@@ -269,15 +462,17 @@ namespace ruby::inv
     using type = Ret(Args... Pack) Qual noexcept(IN);      \
   };
 
-#define RUBY_DEFINE_MAKE_FUNCTION(C, V, R, IV) \
-  RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, RUBY_MAYBE_CVREF(C, V, R), RUBY_MAYBE_VARIADIC(IV))
-
 #define RUBY_DEFINE_FUNCTION_TRAITS_IMPL(C, V, R, IV, Qual, Pack)  \
   template<bool IN, typename Ret, typename... Args>           \
   struct function_traits<Ret(Args... Pack) Qual noexcept(IN)> \
     : function_types<C, V, R, IV, IN, Ret, Args...>           \
   {};
 
+#endif
+
+#define RUBY_DEFINE_MAKE_FUNCTION(C, V, R, IV) \
+  RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, RUBY_MAYBE_CVREF(C, V, R), RUBY_MAYBE_VARIADIC(IV))
+
 #define RUBY_DEFINE_FUNCTION_TRAITS(C, V, R, IV) \
   RUBY_DEFINE_FUNCTION_TRAITS_IMPL(C, V, R, IV, RUBY_MAYBE_CVREF(C, V, R), RUBY_MAYBE_VARIADIC(IV))
 
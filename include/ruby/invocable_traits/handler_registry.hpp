@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  /** A handler and the name it is registered under. */
+  template<typename F>
+  struct named_handler
+  {
+    std::string_view name;
+    F handler;
+  };
+
+  template<typename F>
+  named_handler(std::string_view, F) -> named_handler<F>;
+
+  namespace invocable_impl
+  {
+    template<typename F, typename Signature>
+    inline constexpr bool const_invocable_as_v = false;
+
+    template<typename F, typename R, typename... Args>
+    inline constexpr bool const_invocable_as_v<F, R(Args...)> =
+        std::invocable<F const &, Args...>;
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** The signature of 'F', without qualifiers, is 'Signature', and 'F' can be called through a
+   * const reference.
+   */
+  template<typename F, typename Signature>
+  concept registry_handler =
+    std::is_object_v<F> &&
+    invoke_deducible<F> &&
+    std::same_as<function_remove_qualifiers_t<invocable_function_t<F>>, Signature> &&
+    invocable_impl::const_invocable_as_v<F, Signature>;
+
+  // clang-format on
+
+  namespace invocable_impl
+  {
+    /** FNV-1a, with the seed folded into the offset basis. */
+    constexpr std::uint64_t seeded_hash(std::uint64_t seed, std::string_view text) noexcept
+    {
+      auto hash = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+      for(char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+      }
+      return hash ^ (hash >> 29);
+    }
+
+    /**
+     * Perfect "hash and displace" table over 'N' names: every name is first hashed to
+     * a bucket, and every bucket stores the seed that sends all its names to distinct free
+     * slots. A lookup is two hashes and one string comparison.
+     */
+    template<std::size_t N>
+    struct perfect_hash
+    {
+      static constexpr std::size_t bucket_count = std::bit_ceil(std::max<std::size_t>(N, 1));
+      static constexpr std::size_t slot_count = 2 * bucket_count;
+      static constexpr std::uint32_t max_seed = 1u << 20;
+
+      std::array<std::uint32_t, bucket_count> seeds {};
+      std::array<std::uint32_t, slot_count> slots {}; // index + 1, 0 when empty
+
+      static constexpr std::size_t bucket_of(std::string_view name) noexcept
+      {
+        return seeded_hash(0, name) & (bucket_count - 1);
+      }
+
+      static constexpr std::size_t slot_of(std::uint32_t seed, std::string_view name) noexcept
+      {
+        return seeded_hash(seed, name) & (slot_count - 1);
+      }
+
+      constexpr explicit perfect_hash(std::array<std::string_view, N> const & names)
+      {
+        for(std::size_t i = 0; i < N; ++i)
+          for(std::size_t j = 0; j < i; ++j)
+            if(names[i] == names[j])
+              throw std::invalid_argument("handler_registry: duplicate handler name");
+
+        auto sizes = std::array<std::size_t, bucket_count> {};
+        for(auto const & name : names)
+          ++sizes[bucket_of(name)];
+
+        // Place the largest buckets first, while most slots are still free.
+        auto order = std::array<std::size_t, bucket_count> {};
+        for(std::size_t b = 0; b < bucket_count; ++b)
+          order[b] = b;
+        std::ranges::sort(order, [&](auto x, auto y) { return sizes[x] > sizes[y]; });
+
+        for(auto bucket : order) {
+          if(sizes[bucket] == 0)
+            break;
+          seeds[bucket] = place(names, bucket);
+        }
+      }
+
+      constexpr std::uint32_t place(std::array<std::string_view, N> const & names,
+                                    std::size_t bucket)
+      {
+        for(std::uint32_t seed = 1; seed < max_seed; ++seed) {
+          auto taken = std::array<std::size_t, N> {};
+          std::size_t count = 0;
+          bool fits = true;
+          for(std::size_t i = 0; i < N && fits; ++i) {
+            if(bucket_of(names[i]) != bucket)
+              continue;
+            auto const slot = slot_of(seed, names[i]);
+            fits = slots[slot] == 0 &&
+                   std::find(taken.begin(), taken.begin() + count, slot) == taken.begin() + count;
+            taken[count++] = slot;
+          }
+          if(!fits)
+            continue;
+          for(std::size_t i = 0; i < N; ++i)
+            if(bucket_of(names[i]) == bucket)
+              slots[slot_of(seed, names[i])] = static_cast<std::uint32_t>(i + 1);
+          return seed;
+        }
+        throw std::logic_error("handler_registry: no perfect hash found");
+      }
+
+      /** Index of the only candidate for 'name', or N when no name can match. */
+      constexpr std::size_t candidate(std::string_view name) const noexcept
+      {
+        auto const entry = slots[slot_of(seeds[bucket_of(name)], name)];
+        return entry == 0 ? N : entry - 1;
+      }
+    };
+  } // namespace invocable_impl
+
+  template<typename Signature, typename... Fs>
+  class handler_registry;
+
+  /**
+   * Maps names, fixed at construction, to handlers of the normalized signature 'R(Args...)'.
+   * The constructor builds a perfect hash over the names, so a lookup never collides and never
+   * allocates; when the registry is a constexpr variable, duplicate names are compile errors.
+   * Handlers are stored by value and called through a table of function pointers.
+   */
+  template<typename R, typename... Args, typename... Fs>
+    requires(registry_handler<Fs, R(Args...)> && ...)
+  class handler_registry<R(Args...), Fs...>
+  {
+    static constexpr std::size_t count = sizeof...(Fs);
+
+    using handlers_type = std::tuple<Fs...>;
+    using invoker = R (*)(handlers_type const &, Args...);
+
+    template<std::size_t I>
+    static R invoke_at(handlers_type const & handlers, Args... args)
+    {
+      return std::invoke(std::get<I>(handlers), std::forward<Args>(args)...);
+    }
+
+    template<std::size_t... I>
+    static constexpr auto make_invokers(std::index_sequence<I...>) noexcept
+    {
+      return std::array<invoker, count> {&invoke_at<I>...};
+    }
+
+    static constexpr auto invokers = make_invokers(std::index_sequence_for<Fs...>());
+
+    handlers_type m_handlers;
+    std::array<std::string_view, count> m_names;
+    invocable_impl::perfect_hash<count> m_hash;
+
+  public:
+    using signature_type = R(Args...);
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    constexpr explicit handler_registry(named_handler<Fs>... handlers)
+      : m_handlers(std::move(handlers.handler)...)
+      , m_names {handlers.name...}
+      , m_hash(m_names)
+    {}
+
+    /** Position of the handler named 'name', or npos. */
+    constexpr std::size_t index_of(std::string_view name) const noexcept
+    {
+      auto const index = m_hash.candidate(name);
+      return index < count && m_names[index] == name ? index : npos;
+    }
+
+    constexpr bool contains(std::string_view name) const noexcept
+    {
+      return index_of(name) != npos;
+    }
+
+    constexpr std::string_view name(std::size_t index) const noexcept
+    {
+      return m_names[index];
+    }
+
+    static constexpr std::size_t size() noexcept
+    {
+      return count;
+    }
+
+    /** Calls the handler at position 'index', which must be valid. */
+    R invoke(std::size_t index, Args... args) const
+    {
+      return invokers[index](m_handlers, std::forward<Args>(args)...);
+    }
+
+    /** Calls the handler named 'name'. Throws std::out_of_range if there is none. */
+    R call(std::string_view name, Args... args) const
+    {
+      auto const index = index_of(name);
+      if(index == npos)
+        throw std::out_of_range("handler_registry: unknown handler name");
+      return invoke(index, std::forward<Args>(args)...);
+    }
+  };
+
+  /** Builds the registry of 'handlers', checking each one against 'Signature'. */
+  template<typename Signature, typename... Fs>
+    requires(registry_handler<Fs, Signature> && ...)
+  constexpr auto make_handler_registry(named_handler<Fs>... handlers)
+      -> handler_registry<Signature, Fs...>
+  {
+    return handler_registry<Signature, Fs...>(std::move(handlers)...);
+  }
+
+} // namespace ruby::inv
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "./member_function_pointer_traits.hpp"
+
+namespace ruby::inv
+{
+  /** Number of elements ahead of the current one that invoke_each prefetches.
+   */
+  inline constexpr std::size_t invoke_each_prefetch_distance = 8;
+
+  // clang-format off
+
+  /** 'M' is a pointer to a member function of 'C' (or of a base of 'C'),
+   * callable on an lvalue of 'C' with arguments of types 'Args'.
+   */
+  template<typename M, typename C, typename... Args>
+  concept member_function_of =
+    std::is_member_function_pointer_v<M> &&
+    std::derived_from<std::remove_cv_t<C>, member_function_pointer_class_t<M>> &&
+    std::invocable<M, C &, Args...>;
+
+  // clang-format on
+
+  namespace invocable_impl
+  {
+    inline void prefetch(void const * address) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(address);
+#else
+      (void)address;
+#endif
+    }
+
+    template<typename C, typename Fn>
+    void for_each_prefetched(std::span<C> objects, Fn && fn)
+    {
+      auto const size = objects.size();
+      auto const prefetched = size > invoke_each_prefetch_distance
+                                  ? size - invoke_each_prefetch_distance
+                                  : std::size_t(0);
+
+      std::size_t i = 0;
+      for(; i < prefetched; ++i) {
+        prefetch(&objects[i + invoke_each_prefetch_distance]);
+        fn(objects[i]);
+      }
+      for(; i < size; ++i)
+        fn(objects[i]);
+    }
+
+    template<typename C, typename Fn>
+    void for_each_chunked(std::size_t threads, std::span<C> objects, Fn const & fn)
+    {
+      threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(objects.size(), 1));
+      auto const chunk = (objects.size() + threads - 1) / threads;
+
+      auto failed = std::atomic<bool>(false);
+      auto error = std::exception_ptr();
+
+      auto work = [&](std::span<C> part) {
+        try {
+          for_each_prefetched(part, [&](C & object) {
+            if(!failed.load(std::memory_order_relaxed))
+              fn(object);
+          });
+        } catch(...) {
+          if(!failed.exchange(true, std::memory_order_relaxed))
+            error = std::current_exception();
+        }
+      };
+
+      {
+        auto workers = std::vector<std::jthread>();
+        workers.reserve(threads - 1);
+        for(std::size_t t = 1; t < threads; ++t) {
+          auto const first = std::min(t * chunk, objects.size());
+          auto const count = std::min(chunk, objects.size() - first);
+          workers.emplace_back(work, objects.subspan(first, count));
+        }
+        work(objects.first(std::min(chunk, objects.size())));
+      }
+
+      if(error)
+        std::rethrow_exception(error);
+    }
+  } // namespace invocable_impl
+
+  /** Calls 'method' on every element of 'objects', in order, with the arguments 'args'.
+   * Upcoming elements are prefetched while the current one is processed.
+   */
+  template<typename C, typename M, typename... Args>
+    requires member_function_of<M, C, Args &...>
+  void invoke_each(std::span<C> objects, M method, Args &&... args)
+  {
+    invocable_impl::for_each_prefetched(objects,
+                                        [&](C & object) { (object.*method)(args...); });
+  }
+
+  /** Like invoke_each, but the member function pointer is a template argument, so that
+   * non-virtual member functions are called directly and can be inlined.
+   */
+  template<auto Method, typename C, typename... Args>
+    requires member_function_of<decltype(Method), C, Args &...>
+  void invoke_each(std::span<C> objects, Args &&... args)
+  {
+    invocable_impl::for_each_prefetched(objects,
+                                        [&](C & object) { (object.*Method)(args...); });
+  }
+
+  /** Like invoke_each, but splits 'objects' into 'threads' contiguous chunks processed
+   * concurrently. The calling thread processes the first chunk.
+   * The same 'args' are passed to every call, from all threads.
+   * If a call throws, the remaining elements are skipped and the first exception is rethrown
+   * once every thread has finished.
+   */
+  template<typename C, typename M, typename... Args>
+    requires member_function_of<M, C, Args &...>
+  void invoke_each_parallel(std::size_t threads, std::span<C> objects, M method, Args &&... args)
+  {
+    invocable_impl::for_each_chunked(threads, objects,
+                                     [&](C & object) { (object.*method)(args...); });
+  }
+
+  /** Like invoke_each_parallel, with the member function pointer as a template argument.
+   */
+  template<auto Method, typename C, typename... Args>
+    requires member_function_of<decltype(Method), C, Args &...>
+  void invoke_each_parallel(std::size_t threads, std::span<C> objects, Args &&... args)
+  {
+    invocable_impl::for_each_chunked(threads, objects,
+                                     [&](C & object) { (object.*Method)(args...); });
+  }
+
+} // namespace ruby::inv
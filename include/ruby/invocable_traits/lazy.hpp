@@ -0,0 +1,303 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./deferred_call.hpp"
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  /** Tag allowing a lazy value to cache a reference returned by its callable. */
+  struct allow_reference_t
+  {
+    explicit allow_reference_t() = default;
+  };
+
+  inline constexpr auto allow_reference = allow_reference_t();
+
+  namespace invocable_impl
+  {
+    /** Storage for the result of a lazy evaluation, constructed at most once. */
+    template<typename R>
+    struct lazy_value
+    {
+      union
+      {
+        R value;
+      };
+
+      lazy_value() noexcept
+      {}
+
+      ~lazy_value()
+      {}
+
+      template<typename Fn>
+      void emplace(Fn && fn)
+      {
+        ::new(static_cast<void *>(std::addressof(value))) R(std::forward<Fn>(fn)());
+      }
+
+      R const & get() const noexcept
+      {
+        return value;
+      }
+
+      void destroy() noexcept
+      {
+        std::destroy_at(std::addressof(value));
+      }
+    };
+
+    /** References are cached by address, and always read back as lvalues. */
+    template<typename R>
+      requires std::is_reference_v<R>
+    struct lazy_value<R>
+    {
+      std::remove_reference_t<R> * pointer = nullptr;
+
+      template<typename Fn>
+      void emplace(Fn && fn)
+      {
+        R result = std::forward<Fn>(fn)();
+        pointer = std::addressof(result);
+      }
+
+      std::remove_reference_t<R> & get() const noexcept
+      {
+        return *pointer;
+      }
+
+      void destroy() noexcept
+      {}
+    };
+
+    template<typename F, std::size_t... I>
+    constexpr bool lvalue_invocable(std::index_sequence<I...>)
+    {
+      return std::invocable<F &, std::tuple_element_t<I, invocable_decayed_args_t<F>> &...>;
+    }
+
+    /** Invokes a deferred_call with its stored arguments as lvalues, so it can be retried. */
+    template<typename F, std::size_t... I>
+    decltype(auto) invoke_retryable(deferred_call<F> & call, std::index_sequence<I...>)
+    {
+      return std::invoke(call.template get<0>(), call.template get<I + 1>()...);
+    }
+
+    template<typename F>
+    decltype(auto) invoke_retryable(deferred_call<F> & call)
+    {
+      constexpr auto arity = std::tuple_size_v<invocable_decayed_args_t<F>>;
+      return invoke_retryable(call, std::make_index_sequence<arity>());
+    }
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** 'F' can compute a lazy value: a deducible callable, invocable with lvalues of its stored
+   * arguments, returning an object type, or a reference when 'AllowReference' is true.
+   */
+  template<typename F, bool AllowReference>
+  concept lazy_computable =
+    std::is_object_v<F> &&
+    invoke_deducible<F> &&
+    !std::is_member_pointer_v<F> &&
+    !std::is_void_v<invocable_ret_t<F>> &&
+    (AllowReference || !std::is_reference_v<invocable_ret_t<F>>) &&
+    invocable_impl::lvalue_invocable<F>(
+      std::make_index_sequence<std::tuple_size_v<invocable_decayed_args_t<F>>>());
+
+  // clang-format on
+
+  /**
+   * A value computed by 'F' from stored arguments on first access, then cached.
+   * Once the value exists, get() is a single acquire load. Threads arriving while another one
+   * evaluates sleep on the state word (std::atomic::wait) until the value is ready. If the
+   * evaluation throws, the exception reaches the evaluating thread and the next access retries,
+   * which is why the stored arguments are passed as lvalues.
+   * A callable returning a reference is rejected unless 'AllowReference' is true, see
+   * allow_reference.
+   */
+  template<typename F, bool AllowReference = false>
+    requires lazy_computable<F, AllowReference>
+  class lazy
+  {
+    enum state : std::uint32_t
+    {
+      empty,
+      running,
+      contended,
+      ready
+    };
+
+    mutable deferred_call<F> m_call;
+    mutable invocable_impl::lazy_value<invocable_ret_t<F>> m_value;
+    mutable std::atomic<std::uint32_t> m_state = empty;
+
+    void evaluate() const
+    {
+      auto current = m_state.load(std::memory_order_acquire);
+      while(current != ready) {
+        if(current == empty) {
+          if(!m_state.compare_exchange_weak(current, running, std::memory_order_acquire))
+            continue;
+
+          try {
+            m_value.emplace([this]() -> decltype(auto) {
+              return invocable_impl::invoke_retryable(m_call);
+            });
+          } catch(...) {
+            if(m_state.exchange(empty, std::memory_order_release) == contended)
+              m_state.notify_all();
+            throw;
+          }
+
+          if(m_state.exchange(ready, std::memory_order_release) == contended)
+            m_state.notify_all();
+          return;
+        }
+
+        if(current == running &&
+           !m_state.compare_exchange_weak(current, contended, std::memory_order_acquire))
+          continue;
+
+        m_state.wait(contended, std::memory_order_acquire);
+        current = m_state.load(std::memory_order_acquire);
+      }
+    }
+
+  public:
+    using function_type = F;
+    using value_type = invocable_ret_t<F>;
+    using reference = decltype(std::declval<invocable_impl::lazy_value<value_type> const &>().get());
+
+    template<typename... Args>
+      requires std::constructible_from<deferred_call<F>, F, Args...>
+    explicit lazy(F fn, Args &&... args)
+      : m_call(std::move(fn), std::forward<Args>(args)...)
+    {}
+
+    template<typename... Args>
+      requires AllowReference && std::constructible_from<deferred_call<F>, F, Args...>
+    lazy(allow_reference_t, F fn, Args &&... args)
+      : m_call(std::move(fn), std::forward<Args>(args)...)
+    {}
+
+    lazy(lazy const &) = delete;
+    lazy & operator=(lazy const &) = delete;
+
+    ~lazy()
+    {
+      if(m_state.load(std::memory_order_acquire) == ready)
+        m_value.destroy();
+    }
+
+    /** The value, computing it on the first call. */
+    reference get() const
+    {
+      if(m_state.load(std::memory_order_acquire) != ready) [[unlikely]]
+        evaluate();
+      return m_value.get();
+    }
+
+    reference operator*() const
+    {
+      return get();
+    }
+
+    auto * operator->() const
+    {
+      return std::addressof(get());
+    }
+
+    bool has_value() const noexcept
+    {
+      return m_state.load(std::memory_order_acquire) == ready;
+    }
+  };
+
+  template<typename F, typename... Args>
+  lazy(F, Args...) -> lazy<F>;
+
+  template<typename F, typename... Args>
+  lazy(allow_reference_t, F, Args...) -> lazy<F, true>;
+
+  /** A lazy value for single-threaded use, with a plain flag instead of an atomic state. */
+  template<typename F, bool AllowReference = false>
+    requires lazy_computable<F, AllowReference>
+  class local_lazy
+  {
+    mutable deferred_call<F> m_call;
+    mutable invocable_impl::lazy_value<invocable_ret_t<F>> m_value;
+    mutable bool m_ready = false;
+
+  public:
+    using function_type = F;
+    using value_type = invocable_ret_t<F>;
+    using reference = decltype(std::declval<invocable_impl::lazy_value<value_type> const &>().get());
+
+    template<typename... Args>
+      requires std::constructible_from<deferred_call<F>, F, Args...>
+    explicit local_lazy(F fn, Args &&... args)
+      : m_call(std::move(fn), std::forward<Args>(args)...)
+    {}
+
+    template<typename... Args>
+      requires AllowReference && std::constructible_from<deferred_call<F>, F, Args...>
+    local_lazy(allow_reference_t, F fn, Args &&... args)
+      : m_call(std::move(fn), std::forward<Args>(args)...)
+    {}
+
+    local_lazy(local_lazy const &) = delete;
+    local_lazy & operator=(local_lazy const &) = delete;
+
+    ~local_lazy()
+    {
+      if(m_ready)
+        m_value.destroy();
+    }
+
+    /** The value, computing it on the first call. */
+    reference get() const
+    {
+      if(!m_ready) [[unlikely]] {
+        m_value.emplace([this]() -> decltype(auto) {
+          return invocable_impl::invoke_retryable(m_call);
+        });
+        m_ready = true;
+      }
+      return m_value.get();
+    }
+
+    reference operator*() const
+    {
+      return get();
+    }
+
+    auto * operator->() const
+    {
+      return std::addressof(get());
+    }
+
+    bool has_value() const noexcept
+    {
+      return m_ready;
+    }
+  };
+
+  template<typename F, typename... Args>
+  local_lazy(F, Args...) -> local_lazy<F>;
+
+  template<typename F, typename... Args>
+  local_lazy(allow_reference_t, F, Args...) -> local_lazy<F, true>;
+
+} // namespace ruby::inv
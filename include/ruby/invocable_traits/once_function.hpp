@@ -0,0 +1,155 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+#include "./task.hpp"
+
+namespace ruby::inv
+{
+  template<typename Signature>
+  class once_function;
+
+  namespace invocable_impl
+  {
+    /** std::invoke_r, which is C++23. */
+    template<typename R, typename F, typename... Args>
+    constexpr R invoke_as(F && fn, Args &&... args)
+    {
+      if constexpr(std::is_void_v<R>)
+        std::invoke(std::forward<F>(fn), std::forward<Args>(args)...);
+      else
+        return std::invoke(std::forward<F>(fn), std::forward<Args>(args)...);
+    }
+
+    template<typename R, typename... Args>
+    struct once_vtable
+    {
+      R (*call)(std::byte * storage, Args &&... args);
+      relocate_fn relocate;
+      destroy_fn destroy;
+    };
+
+    template<typename F, typename R, typename... Args>
+    struct once_inline_vtable
+    {
+      static constexpr auto value = once_vtable<R, Args...> {
+          [](std::byte * storage, Args &&... args) -> R {
+            return invoke_as<R>(std::move(inline_object<F>(storage)), std::forward<Args>(args)...);
+          },
+          inline_relocate<F>(),
+          inline_destroy<F>()};
+    };
+
+    template<typename F, typename R, typename... Args>
+    struct once_heap_vtable
+    {
+      static constexpr auto value = once_vtable<R, Args...> {
+          [](std::byte * storage, Args &&... args) -> R {
+            return invoke_as<R>(std::move(*heap_object<F>(storage)), std::forward<Args>(args)...);
+          },
+          &relocate_pointer,
+          &destroy_heap<F>};
+    };
+  } // namespace invocable_impl
+
+  /**
+   * Move-only, call-once, type-erased callable of signature 'R(Args...)'.
+   * The stored callable is invoked as an rvalue, so '&&'-qualified call operators are accepted
+   * and captured resources can be moved out of it instead of copied. It is destroyed as soon as
+   * the call returns or throws, leaving the once_function empty. Storage follows task: small
+   * callables are kept inline, larger ones are allocated.
+   */
+  template<typename R, typename... Args>
+  class once_function<R(Args...)>
+  {
+    using vtable_type = invocable_impl::once_vtable<R, Args...>;
+
+    alignas(std::max_align_t) std::byte m_storage[task_inline_size];
+    vtable_type const * m_vtable = nullptr;
+
+    void reset() noexcept
+    {
+      if(m_vtable)
+        std::exchange(m_vtable, nullptr)->destroy(m_storage);
+    }
+
+  public:
+    using signature_type = R(Args...);
+
+    once_function() noexcept = default;
+
+    template<typename F>
+      requires(!std::same_as<std::decay_t<F>, once_function>) &&
+              std::is_invocable_r_v<R, std::decay_t<F>, Args...>
+    once_function(F && fn)
+    {
+      using T = std::decay_t<F>;
+      if constexpr(invocable_impl::is_task_inline_v<T>) {
+        ::new(static_cast<void *>(m_storage)) T(std::forward<F>(fn));
+        m_vtable = &invocable_impl::once_inline_vtable<T, R, Args...>::value;
+      } else {
+        ::new(static_cast<void *>(m_storage)) T *(new T(std::forward<F>(fn)));
+        m_vtable = &invocable_impl::once_heap_vtable<T, R, Args...>::value;
+      }
+    }
+
+    once_function(once_function && other) noexcept
+      : m_vtable(std::exchange(other.m_vtable, nullptr))
+    {
+      if(m_vtable)
+        m_vtable->relocate(other.m_storage, m_storage);
+    }
+
+    once_function & operator=(once_function && other) noexcept
+    {
+      if(this != &other) {
+        reset();
+        m_vtable = std::exchange(other.m_vtable, nullptr);
+        if(m_vtable)
+          m_vtable->relocate(other.m_storage, m_storage);
+      }
+      return *this;
+    }
+
+    ~once_function()
+    {
+      reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+      return m_vtable != nullptr;
+    }
+
+    /** Invokes the stored callable, which must exist, as an rvalue and destroys it. */
+    R operator()(Args... args) &&
+    {
+      struct destroy_guard
+      {
+        once_function & self;
+
+        ~destroy_guard()
+        {
+          self.reset();
+        }
+      } guard {*this};
+
+      return m_vtable->call(m_storage, std::forward<Args>(args)...);
+    }
+  };
+
+  /** Deduces the signature of 'F' without its qualifiers, so function objects whose call
+   * operator is '&&'-qualified deduce the same once_function as the others.
+   */
+  template<typename F>
+    requires invoke_deducible<std::decay_t<F>> && (!std::is_member_pointer_v<std::decay_t<F>>)
+  once_function(F &&) -> once_function<invocable_signature_t<std::decay_t<F>>>;
+
+} // namespace ruby::inv
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./invocable_traits.hpp"
+#include "./wait_strategy.hpp"
+
+namespace ruby::inv
+{
+  /** Inputs shorter than this are transformed sequentially by transform_execution::automatic.
+   */
+  inline constexpr std::size_t par_transform_threshold = 1 << 14;
+
+  /** Approximate size of the output written by one task of a parallel transform.
+   */
+  inline constexpr std::size_t par_transform_chunk_bytes = 16 * 1024;
+
+  /** How par_transform runs. 'automatic' is parallel for inputs of at least
+   * par_transform_threshold elements and callables that can be shared between threads.
+   */
+  enum class transform_execution
+  {
+    automatic,
+    sequential,
+    parallel
+  };
+
+  // clang-format off
+
+  /** 'F' maps the elements of the random access range 'R' to values of the return type it
+   * declares.
+   */
+  template<typename R, typename F>
+  concept par_transformable =
+    std::ranges::random_access_range<R> &&
+    std::ranges::sized_range<R> &&
+    std::is_object_v<F> &&
+    invoke_deducible<F> &&
+    std::invocable<F &, std::ranges::range_reference_t<R>> &&
+    !std::is_void_v<invocable_ret_t<F>> &&
+    std::constructible_from<std::remove_cvref_t<invocable_ret_t<F>>,
+                            std::invoke_result_t<F &, std::ranges::range_reference_t<R>>>;
+
+  // clang-format on
+
+  template<typename T>
+  class transform_result;
+
+  namespace invocable_impl
+  {
+    /** Function pointers and const call operators can be called from several threads at once. */
+    template<typename F>
+    inline constexpr bool is_shareable_callable_v = !std::is_class_v<F> || invocable_is_const_v<F>;
+
+    /**
+     * Uninitialized, cache line aligned output of a transform, split into chunks whose
+     * boundaries fall on cache line boundaries, so no line is written by two threads. Every
+     * chunk records how many of its elements were constructed, which are destroyed if the
+     * transform does not complete.
+     */
+    template<typename T>
+    struct transform_builder
+    {
+      static constexpr auto alignment = std::align_val_t(std::max(alignof(T), cache_line_size));
+      static constexpr std::size_t line_elements =
+          std::lcm(sizeof(T), cache_line_size) / sizeof(T);
+
+      static constexpr std::size_t chunk_elements = std::max(
+          line_elements, par_transform_chunk_bytes / sizeof(T) / line_elements * line_elements);
+
+      T * data;
+      std::size_t size;
+      std::size_t chunk;
+      std::vector<std::size_t> constructed;
+
+      transform_builder(std::size_t count, std::size_t chunk_size)
+        : data(count == 0 ? nullptr
+                          : static_cast<T *>(::operator new(count * sizeof(T), alignment)))
+        , size(count)
+        , chunk(std::max<std::size_t>(chunk_size, 1))
+        , constructed((count + chunk - 1) / chunk, 0)
+      {}
+
+      transform_builder(transform_builder const &) = delete;
+      transform_builder & operator=(transform_builder const &) = delete;
+
+      ~transform_builder()
+      {
+        if(!data)
+          return;
+        for(std::size_t c = 0; c < constructed.size(); ++c)
+          std::destroy_n(data + c * chunk, constructed[c]);
+        ::operator delete(data, alignment);
+      }
+
+      std::size_t chunks() const noexcept
+      {
+        return constructed.size();
+      }
+
+      template<typename Iter, typename F>
+      void fill(std::size_t c, Iter first, F & fn)
+      {
+        auto const begin = c * chunk;
+        auto const end = std::min(begin + chunk, size);
+        auto i = begin;
+        try {
+          for(; i < end; ++i)
+            ::new(static_cast<void *>(data + i)) T(std::invoke(fn, first[i]));
+        } catch(...) {
+          constructed[c] = i - begin;
+          throw;
+        }
+        constructed[c] = end - begin;
+      }
+
+      transform_result<T> release() && noexcept
+      {
+        return transform_result<T>(std::exchange(data, nullptr), size);
+      }
+    };
+
+    template<typename T, typename Iter, typename F>
+    transform_result<T> transform_parallel(std::size_t threads, Iter first, std::size_t size,
+                                           F & fn)
+    {
+      auto builder = transform_builder<T>(size, transform_builder<T>::chunk_elements);
+      threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(builder.chunks(), 1));
+
+      auto next = std::atomic<std::size_t>(0);
+      auto failed = std::atomic<bool>(false);
+      auto error = std::exception_ptr();
+
+      auto work = [&] {
+        try {
+          for(auto c = next.fetch_add(1, std::memory_order_relaxed);
+              c < builder.chunks() && !failed.load(std::memory_order_relaxed);
+              c = next.fetch_add(1, std::memory_order_relaxed))
+            builder.fill(c, first, fn);
+        } catch(...) {
+          if(!failed.exchange(true, std::memory_order_relaxed))
+            error = std::current_exception();
+        }
+      };
+
+      {
+        auto workers = std::vector<std::jthread>();
+        workers.reserve(threads - 1);
+        for(std::size_t t = 1; t < threads; ++t)
+          workers.emplace_back(work);
+        work();
+      }
+
+      if(error)
+        std::rethrow_exception(error);
+      return std::move(builder).release();
+    }
+
+    template<typename T, typename Iter, typename F>
+    transform_result<T> transform_sequential(Iter first, std::size_t size, F & fn)
+    {
+      auto builder = transform_builder<T>(size, size);
+      if(builder.chunks() != 0)
+        builder.fill(0, first, fn);
+      return std::move(builder).release();
+    }
+  } // namespace invocable_impl
+
+  /** The output of par_transform: a fixed size array whose elements were constructed in place,
+   * in cache line aligned storage.
+   */
+  template<typename T>
+  class transform_result
+  {
+    static constexpr auto alignment = invocable_impl::transform_builder<T>::alignment;
+
+    T * m_data = nullptr;
+    std::size_t m_size = 0;
+
+    friend struct invocable_impl::transform_builder<T>;
+
+    transform_result(T * data, std::size_t size) noexcept
+      : m_data(data)
+      , m_size(size)
+    {}
+
+    void reset() noexcept
+    {
+      if(m_data) {
+        std::destroy_n(m_data, m_size);
+        ::operator delete(std::exchange(m_data, nullptr), alignment);
+      }
+      m_size = 0;
+    }
+
+  public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = T const *;
+
+    transform_result() noexcept = default;
+
+    transform_result(transform_result && other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr))
+      , m_size(std::exchange(other.m_size, 0))
+    {}
+
+    transform_result & operator=(transform_result && other) noexcept
+    {
+      if(this != &other) {
+        reset();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+      }
+      return *this;
+    }
+
+    ~transform_result()
+    {
+      reset();
+    }
+
+    std::size_t size() const noexcept
+    {
+      return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+    T * data() noexcept
+    {
+      return m_data;
+    }
+
+    T const * data() const noexcept
+    {
+      return m_data;
+    }
+
+    iterator begin() noexcept
+    {
+      return m_data;
+    }
+
+    iterator end() noexcept
+    {
+      return m_data + m_size;
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return m_data;
+    }
+
+    const_iterator end() const noexcept
+    {
+      return m_data + m_size;
+    }
+
+    T & operator[](std::size_t index) noexcept
+    {
+      return m_data[index];
+    }
+
+    T const & operator[](std::size_t index) const noexcept
+    {
+      return m_data[index];
+    }
+
+    operator std::span<T>() noexcept
+    {
+      return {m_data, m_size};
+    }
+
+    operator std::span<T const>() const noexcept
+    {
+      return {m_data, m_size};
+    }
+  };
+
+  /**
+   * Applies 'fn' to every element of 'range', and returns the results, of the decayed
+   * invocable_ret_t of 'fn', constructed in place in a single allocation.
+   * In parallel, the output is split into chunks of about par_transform_chunk_bytes starting on
+   * cache line boundaries, claimed in order by the calling thread and up to 'threads' - 1
+   * local workers. With transform_execution::automatic, small inputs and callables with a
+   * non-const call operator are transformed sequentially; transform_execution::parallel forces
+   * concurrent calls, and the caller is then responsible for their safety.
+   * If a call throws, the remaining chunks are skipped, the constructed elements are destroyed
+   * and the first exception is rethrown.
+   */
+  template<typename R, typename F>
+    requires par_transformable<R, F>
+  auto par_transform(R && range, F fn, std::size_t threads,
+                     transform_execution execution = transform_execution::automatic)
+      -> transform_result<std::remove_cvref_t<invocable_ret_t<F>>>
+  {
+    using T = std::remove_cvref_t<invocable_ret_t<F>>;
+
+    auto const first = std::ranges::begin(range);
+    auto const size = static_cast<std::size_t>(std::ranges::size(range));
+
+    auto parallel = execution == transform_execution::parallel;
+    if(execution == transform_execution::automatic)
+      parallel = invocable_impl::is_shareable_callable_v<F> && threads > 1 &&
+                 size >= par_transform_threshold;
+
+    if(parallel)
+      return invocable_impl::transform_parallel<T>(threads, first, size, fn);
+    return invocable_impl::transform_sequential<T>(first, size, fn);
+  }
+
+} // namespace ruby::inv
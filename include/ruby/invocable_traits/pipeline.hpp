@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./continuation.hpp"
+#include "./invocable_traits.hpp"
+#include "./ring_buffer.hpp"
+#include "./wait_strategy.hpp"
+
+namespace ruby::inv
+{
+  /** Default capacity of the queues between the stages of a pipeline. */
+  inline constexpr std::size_t pipeline_queue_capacity = 1024;
+
+  /** Number of items a pipeline stage takes from its queue before publishing its progress. */
+  inline constexpr std::size_t pipeline_batch_size = 64;
+
+  namespace invocable_impl
+  {
+    /** The items entering each stage: the argument of the first one, then the decayed result
+     * of every stage but the last.
+     */
+    template<typename Stages,
+             typename Sequence = std::make_index_sequence<std::tuple_size_v<Stages> - 1>>
+    struct pipeline_items;
+
+    template<typename... Stages, std::size_t... I>
+    struct pipeline_items<std::tuple<Stages...>, std::index_sequence<I...>>
+    {
+      using type = std::tuple<
+          std::decay_t<invocable_arg_t<first_stage_t<Stages...>, 0>>,
+          std::decay_t<invocable_ret_t<std::tuple_element_t<I, std::tuple<Stages...>>>>...>;
+    };
+
+    template<typename Wait, typename Items>
+    struct pipeline_queues;
+
+    template<typename Wait, typename... Items>
+    struct pipeline_queues<Wait, std::tuple<Items...>>
+    {
+      using type = std::tuple<spsc_ring<Items, Wait>...>;
+    };
+
+    template<typename Stages, std::size_t... I>
+    constexpr bool is_connected(std::index_sequence<I...>)
+    {
+      return ((!std::is_void_v<invocable_ret_t<std::tuple_element_t<I, Stages>>> &&
+               continuation_of<std::tuple_element_t<I + 1, Stages>,
+                               std::decay_t<invocable_ret_t<std::tuple_element_t<I, Stages>>>>) &&
+              ...);
+    }
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** 'Stages' can run as a pipeline: the first one takes one argument, and every other one
+   * takes the result of the previous one, which is not void.
+   */
+  template<typename... Stages>
+  concept pipeline_stages =
+    (sizeof...(Stages) > 0) &&
+    (chain_stage<Stages> && ...) &&
+    (invocable_arity_v<invocable_impl::first_stage_t<Stages...>> == 1) &&
+    std::invocable<invocable_impl::first_stage_t<Stages...> &,
+                   std::decay_t<invocable_arg_t<invocable_impl::first_stage_t<Stages...>, 0>>> &&
+    invocable_impl::is_connected<std::tuple<Stages...>>(
+        std::make_index_sequence<sizeof...(Stages) - 1>());
+
+  // clang-format on
+
+  /**
+   * Runs every stage on its own thread, connected to the next one by a bounded spsc_ring of the
+   * decayed result of the stage. Items pushed by one producer thread flow through the stages in
+   * order; a stage takes up to pipeline_batch_size items at once from its queue, and waits
+   * with 'Wait' when its next queue is full, so a slow stage holds back the previous ones.
+   * The result of the last stage is discarded.
+   * If a stage throws, the items it is given afterwards are dropped, and finish() rethrows the
+   * first exception, in stage order.
+   */
+  template<typename Wait, typename... Stages>
+    requires pipeline_stages<Stages...>
+  class stage_pipeline
+  {
+  public:
+    static constexpr std::size_t stage_count = sizeof...(Stages);
+
+    using items = typename invocable_impl::pipeline_items<std::tuple<Stages...>>::type;
+    using input_type = std::tuple_element_t<0, items>;
+
+  private:
+    template<std::size_t I>
+    using item_t = std::tuple_element_t<I, items>;
+
+    std::tuple<Stages...> m_stages;
+    typename invocable_impl::pipeline_queues<Wait, items>::type m_queues;
+    std::array<std::atomic<bool>, stage_count> m_closed {};
+    std::array<std::exception_ptr, stage_count> m_errors;
+    std::array<std::jthread, stage_count> m_threads;
+    bool m_finished = false;
+
+    template<std::size_t I>
+    void close() noexcept
+    {
+      m_closed[I].store(true, std::memory_order_release);
+      std::get<I>(m_queues).wake_consumer();
+    }
+
+    template<std::size_t I>
+    void run()
+    {
+      auto & queue = std::get<I>(m_queues);
+      auto step = [this](item_t<I> && item) {
+        if(m_errors[I])
+          return;
+        try {
+          if constexpr(I + 1 == stage_count)
+            std::invoke(std::get<I>(m_stages), std::move(item));
+          else
+            std::get<I + 1>(m_queues).emplace(std::invoke(std::get<I>(m_stages), std::move(item)));
+        } catch(...) {
+          m_errors[I] = std::current_exception();
+        }
+      };
+
+      // Items pushed before the queue was closed are visible once the closing is.
+      for(;;) {
+        auto const closed = m_closed[I].load(std::memory_order_acquire);
+        if(queue.drain(step, pipeline_batch_size) == 0) {
+          if(closed)
+            break;
+          queue.wait_not_empty([&] { return m_closed[I].load(std::memory_order_acquire); });
+        }
+      }
+
+      if constexpr(I + 1 < stage_count)
+        close<I + 1>();
+    }
+
+    template<std::size_t... I>
+    stage_pipeline(std::index_sequence<I...>, std::size_t capacity, Stages... stages)
+      : m_stages(std::move(stages)...)
+      , m_queues((void(I), capacity)...)
+    {
+      try {
+        ((m_threads[I] = std::jthread([this] { run<I>(); })), ...);
+      } catch(...) {
+        close<0>();
+        for(auto & thread : m_threads)
+          if(thread.joinable())
+            thread.join();
+        throw;
+      }
+    }
+
+    void join() noexcept
+    {
+      if(std::exchange(m_finished, true))
+        return;
+      close<0>();
+      for(auto & thread : m_threads)
+        thread.join();
+    }
+
+  public:
+    /** Starts one thread per stage, each reading from a queue of 'capacity' items. */
+    explicit stage_pipeline(std::size_t capacity, Stages... stages)
+      : stage_pipeline(std::index_sequence_for<Stages...>(), capacity, std::move(stages)...)
+    {}
+
+    stage_pipeline(stage_pipeline const &) = delete;
+    stage_pipeline & operator=(stage_pipeline const &) = delete;
+
+    /** Waits for the pushed items to go through, see finish(). Exceptions are discarded. */
+    ~stage_pipeline()
+    {
+      join();
+    }
+
+    /** Pushes an item into the first stage, waiting while its queue is full.
+     * Must be called from a single thread, and not after finish().
+     */
+    template<typename... Args>
+      requires std::constructible_from<input_type, Args...>
+    void push(Args &&... args)
+    {
+      std::get<0>(m_queues).emplace(std::forward<Args>(args)...);
+    }
+
+    /** Pushes an item into the first stage if its queue is not full. */
+    template<typename... Args>
+      requires std::constructible_from<input_type, Args...>
+    bool try_push(Args &&... args)
+    {
+      return std::get<0>(m_queues).try_emplace(std::forward<Args>(args)...);
+    }
+
+    /** Waits until every pushed item went through every stage and stops the threads.
+     * Rethrows the first exception thrown by a stage.
+     */
+    void finish()
+    {
+      join();
+      for(auto & error : m_errors)
+        if(error)
+          std::rethrow_exception(std::exchange(error, nullptr));
+    }
+  };
+
+  /** Starts a stage_pipeline of 'stages', with queues of 'capacity' items. */
+  template<typename Wait = futex_wait, typename... Stages>
+    requires pipeline_stages<std::decay_t<Stages>...>
+  auto pipeline(std::size_t capacity, Stages &&... stages)
+  {
+    return stage_pipeline<Wait, std::decay_t<Stages>...>(capacity, std::forward<Stages>(stages)...);
+  }
+
+  /** Starts a stage_pipeline of 'stages', with queues of pipeline_queue_capacity items. */
+  template<typename Wait = futex_wait, typename... Stages>
+    requires pipeline_stages<std::decay_t<Stages>...>
+  auto pipeline(Stages &&... stages)
+  {
+    return pipeline<Wait>(pipeline_queue_capacity, std::forward<Stages>(stages)...);
+  }
+
+} // namespace ruby::inv
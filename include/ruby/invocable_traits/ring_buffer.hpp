@@ -0,0 +1,370 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "./wait_strategy.hpp"
+
+namespace ruby::inv
+{
+  namespace invocable_impl
+  {
+    template<typename T>
+    struct ring_storage
+    {
+      alignas(T) std::byte bytes[sizeof(T)];
+
+      T * get() noexcept
+      {
+        return std::launder(reinterpret_cast<T *>(bytes));
+      }
+    };
+
+    /** Destroys the front element and advances 'head', even if consuming it threw. */
+    template<typename T>
+    struct consume_guard
+    {
+      T * item;
+      std::size_t & head;
+
+      ~consume_guard()
+      {
+        std::destroy_at(item);
+        ++head;
+      }
+    };
+
+    inline auto ring_capacity(std::size_t capacity) -> std::size_t
+    {
+      return std::bit_ceil(std::max<std::size_t>(capacity, 2));
+    }
+  } // namespace invocable_impl
+
+  /**
+   * Bounded lock-free queue with one producer and one consumer thread.
+   * The capacity is rounded up to a power of two. Elements are constructed in place and handed
+   * to the consumer as rvalues in batches; the consumer publishes its progress once per batch.
+   */
+  template<typename T, typename Wait = yield_wait>
+  class spsc_ring
+  {
+    using slot = invocable_impl::ring_storage<T>;
+
+    std::size_t m_mask;
+    std::unique_ptr<slot[]> m_slots;
+
+    alignas(cache_line_size) std::atomic<std::size_t> m_tail {0};
+    std::size_t m_cached_head = 0;
+
+    alignas(cache_line_size) std::atomic<std::size_t> m_head {0};
+    std::size_t m_cached_tail = 0;
+
+    alignas(cache_line_size) Wait m_not_empty;
+    alignas(cache_line_size) Wait m_not_full;
+
+    bool has_space(std::size_t tail) noexcept
+    {
+      if(tail - m_cached_head <= m_mask)
+        return true;
+      m_cached_head = m_head.load(std::memory_order_acquire);
+      return tail - m_cached_head <= m_mask;
+    }
+
+    template<typename... Args>
+    void publish(std::size_t tail, Args &&... args)
+    {
+      std::construct_at(m_slots[tail & m_mask].get(), std::forward<Args>(args)...);
+      m_tail.store(tail + 1, std::memory_order_release);
+      m_not_empty.notify();
+    }
+
+  public:
+    using value_type = T;
+    using wait_strategy = Wait;
+
+    explicit spsc_ring(std::size_t capacity)
+      : m_mask(invocable_impl::ring_capacity(capacity) - 1)
+      , m_slots(std::make_unique_for_overwrite<slot[]>(m_mask + 1))
+    {}
+
+    spsc_ring(spsc_ring const &) = delete;
+    spsc_ring & operator=(spsc_ring const &) = delete;
+
+    ~spsc_ring()
+    {
+      drain([](T &&) {});
+    }
+
+    std::size_t capacity() const noexcept
+    {
+      return m_mask + 1;
+    }
+
+    /** Producer side. Constructs an element from 'args' if the queue is not full. */
+    template<typename... Args>
+      requires std::constructible_from<T, Args...>
+    bool try_emplace(Args &&... args)
+    {
+      auto const tail = m_tail.load(std::memory_order_relaxed);
+      if(!has_space(tail))
+        return false;
+      publish(tail, std::forward<Args>(args)...);
+      return true;
+    }
+
+    /** Producer side. Waits for a free slot, then constructs an element from 'args'. */
+    template<typename... Args>
+      requires std::constructible_from<T, Args...>
+    void emplace(Args &&... args)
+    {
+      auto const tail = m_tail.load(std::memory_order_relaxed);
+      m_not_full.wait_until([&] { return has_space(tail); });
+      publish(tail, std::forward<Args>(args)...);
+    }
+
+    /** Consumer side. Passes up to 'max' elements to 'fn' as rvalues and returns their number. */
+    template<typename Fn>
+    std::size_t drain(Fn && fn, std::size_t max = std::numeric_limits<std::size_t>::max())
+    {
+      auto head = m_head.load(std::memory_order_relaxed);
+      if(m_cached_tail - head < max)
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+
+      auto const first = head;
+      auto const last = head + std::min(m_cached_tail - head, max);
+      if(first == last)
+        return 0;
+
+      struct commit_guard
+      {
+        spsc_ring & ring;
+        std::size_t & head;
+
+        ~commit_guard()
+        {
+          ring.m_head.store(head, std::memory_order_release);
+          ring.m_not_full.notify();
+        }
+      } commit {*this, head};
+
+      while(head != last) {
+        auto * item = m_slots[head & m_mask].get();
+        invocable_impl::consume_guard<T> consume {item, head};
+        fn(std::move(*item));
+      }
+
+      return last - first;
+    }
+
+    /** Consumer side. */
+    bool empty() noexcept
+    {
+      auto const head = m_head.load(std::memory_order_relaxed);
+      if(head != m_cached_tail)
+        return false;
+      m_cached_tail = m_tail.load(std::memory_order_acquire);
+      return head == m_cached_tail;
+    }
+
+    /** Consumer side. Waits until the queue is not empty or 'interrupted()' is true. */
+    template<typename Pred>
+    void wait_not_empty(Pred interrupted)
+    {
+      m_not_empty.wait_until([&] { return interrupted() || !empty(); });
+    }
+
+    /** Wakes the consumer blocked in wait_not_empty, so that it re-checks its interruption. */
+    void wake_consumer() noexcept
+    {
+      m_not_empty.wake();
+    }
+  };
+
+  /**
+   * Bounded lock-free queue with any number of producers and one consumer thread.
+   * Each slot carries a sequence number (Vyukov's bounded queue): producers claim a position with
+   * a compare-and-swap on the tail, and the consumer never writes a shared index.
+   */
+  template<typename T, typename Wait = yield_wait>
+  class mpsc_ring
+  {
+    struct slot : invocable_impl::ring_storage<T>
+    {
+      std::atomic<std::size_t> sequence;
+    };
+
+    std::size_t m_mask;
+    std::unique_ptr<slot[]> m_slots;
+
+    alignas(cache_line_size) std::atomic<std::size_t> m_tail {0};
+    alignas(cache_line_size) std::size_t m_head = 0;
+
+    alignas(cache_line_size) Wait m_not_empty;
+    alignas(cache_line_size) Wait m_not_full;
+
+    bool try_claim(std::size_t & pos) noexcept
+    {
+      pos = m_tail.load(std::memory_order_relaxed);
+      for(;;) {
+        auto const sequence = m_slots[pos & m_mask].sequence.load(std::memory_order_acquire);
+        auto const diff = static_cast<std::intptr_t>(sequence - pos);
+        if(diff == 0) {
+          if(m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            return true;
+        } else if(diff < 0) {
+          return false;
+        } else {
+          pos = m_tail.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    template<typename... Args>
+    void publish(std::size_t pos, Args &&... args) noexcept
+    {
+      auto & target = m_slots[pos & m_mask];
+      std::construct_at(target.get(), std::forward<Args>(args)...);
+      target.sequence.store(pos + 1, std::memory_order_release);
+      m_not_empty.notify();
+    }
+
+    /** A claimed slot must be published, so elements that may throw on construction are built
+     * before claiming and moved in afterwards.
+     */
+    template<typename Claim, typename... Args>
+    bool emplace_with(Claim claim, Args &&... args)
+    {
+      std::size_t pos = 0;
+      if constexpr(std::is_nothrow_constructible_v<T, Args...>) {
+        if(!claim(pos))
+          return false;
+        publish(pos, std::forward<Args>(args)...);
+      } else {
+        auto value = T(std::forward<Args>(args)...);
+        if(!claim(pos))
+          return false;
+        publish(pos, std::move(value));
+      }
+      return true;
+    }
+
+  public:
+    static_assert(std::is_nothrow_move_constructible_v<T>);
+
+    using value_type = T;
+    using wait_strategy = Wait;
+
+    explicit mpsc_ring(std::size_t capacity)
+      : m_mask(invocable_impl::ring_capacity(capacity) - 1)
+      , m_slots(std::make_unique_for_overwrite<slot[]>(m_mask + 1))
+    {
+      for(std::size_t i = 0; i <= m_mask; ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    mpsc_ring(mpsc_ring const &) = delete;
+    mpsc_ring & operator=(mpsc_ring const &) = delete;
+
+    ~mpsc_ring()
+    {
+      drain([](T &&) {});
+    }
+
+    std::size_t capacity() const noexcept
+    {
+      return m_mask + 1;
+    }
+
+    /** Producer side. Constructs an element from 'args' if the queue is not full. */
+    template<typename... Args>
+      requires std::constructible_from<T, Args...>
+    bool try_emplace(Args &&... args)
+    {
+      return emplace_with([this](std::size_t & pos) { return try_claim(pos); },
+                          std::forward<Args>(args)...);
+    }
+
+    /** Producer side. Waits for a free slot, then constructs an element from 'args'. */
+    template<typename... Args>
+      requires std::constructible_from<T, Args...>
+    void emplace(Args &&... args)
+    {
+      emplace_with(
+          [this](std::size_t & pos) {
+            m_not_full.wait_until([&] { return try_claim(pos); });
+            return true;
+          },
+          std::forward<Args>(args)...);
+    }
+
+    /** Consumer side. Passes up to 'max' elements to 'fn' as rvalues and returns their number. */
+    template<typename Fn>
+    std::size_t drain(Fn && fn, std::size_t max = std::numeric_limits<std::size_t>::max())
+    {
+      auto const first = m_head;
+
+      struct commit_guard
+      {
+        mpsc_ring & ring;
+        std::size_t first;
+
+        ~commit_guard()
+        {
+          if(ring.m_head != first)
+            ring.m_not_full.notify();
+        }
+      } commit {*this, first};
+
+      while(m_head - first < max) {
+        auto & current = m_slots[m_head & m_mask];
+        if(current.sequence.load(std::memory_order_acquire) != m_head + 1)
+          break;
+
+        auto const head = m_head;
+        struct release_guard
+        {
+          slot & current;
+          std::size_t sequence;
+
+          ~release_guard()
+          {
+            current.sequence.store(sequence, std::memory_order_release);
+          }
+        } release {current, head + m_mask + 1};
+
+        invocable_impl::consume_guard<T> consume {current.get(), m_head};
+        fn(std::move(*current.get()));
+      }
+
+      return m_head - first;
+    }
+
+    /** Consumer side. */
+    bool empty() const noexcept
+    {
+      auto const & current = m_slots[m_head & m_mask];
+      return current.sequence.load(std::memory_order_acquire) != m_head + 1;
+    }
+
+    /** Consumer side. Waits until the queue is not empty or 'interrupted()' is true. */
+    template<typename Pred>
+    void wait_not_empty(Pred interrupted)
+    {
+      m_not_empty.wait_until([&] { return interrupted() || !empty(); });
+    }
+
+    /** Wakes the consumer blocked in wait_not_empty, so that it re-checks its interruption. */
+    void wake_consumer() noexcept
+    {
+      m_not_empty.wake();
+    }
+  };
+
+} // namespace ruby::inv
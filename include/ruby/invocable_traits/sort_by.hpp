@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./member_object_pointer_traits.hpp"
+
+namespace ruby::inv
+{
+  /** Ranges shorter than this are always sorted with a comparison sort.
+   */
+  inline constexpr std::size_t radix_sort_threshold = 256;
+
+  // clang-format off
+
+  /** A range whose elements can be sorted by the member object pointed to by 'M'.
+   */
+  template<typename R, typename M>
+  concept sortable_by_member =
+    std::is_member_object_pointer_v<M> &&
+    std::ranges::random_access_range<R> &&
+    std::ranges::sized_range<R> &&
+    std::permutable<std::ranges::iterator_t<R>> &&
+    std::derived_from<std::ranges::range_value_t<R>, member_object_pointer_class_t<M>>;
+
+  // clang-format on
+
+  namespace invocable_impl
+  {
+    template<typename M>
+    using sort_key_t = std::remove_cv_t<member_object_pointer_object_t<M>>;
+
+    template<typename K>
+    struct radix_key
+    {
+      using type = void;
+    };
+
+    template<typename K>
+      requires std::is_integral_v<K>
+    struct radix_key<K>
+    {
+      using type = std::make_unsigned_t<K>;
+    };
+
+    template<>
+    struct radix_key<bool>
+    {
+      using type = std::uint8_t;
+    };
+
+    template<typename K>
+      requires std::is_enum_v<K>
+    struct radix_key<K> : radix_key<std::underlying_type_t<K>>
+    {};
+
+    template<typename K>
+      requires std::is_floating_point_v<K> && (sizeof(K) == 4)
+    struct radix_key<K>
+    {
+      using type = std::uint32_t;
+    };
+
+    template<typename K>
+      requires std::is_floating_point_v<K> && (sizeof(K) == 8)
+    struct radix_key<K>
+    {
+      using type = std::uint64_t;
+    };
+
+    /** Unsigned type whose natural order matches the order of 'K', or void if there is none. */
+    template<typename K>
+    using radix_key_t = typename radix_key<K>::type;
+
+    template<typename K>
+    inline constexpr bool is_radix_sortable_v = [] {
+      if constexpr(std::is_void_v<radix_key_t<K>>)
+        return false;
+      else
+        return sizeof(radix_key_t<K>) <= sizeof(std::uint64_t);
+    }();
+
+    /** Maps a key to an unsigned integer preserving its order. */
+    template<typename K>
+    constexpr auto to_radix_key(K key) noexcept -> radix_key_t<K>
+    {
+      using U = radix_key_t<K>;
+
+      if constexpr(std::is_enum_v<K>) {
+        return to_radix_key(static_cast<std::underlying_type_t<K>>(key));
+      } else if constexpr(std::is_floating_point_v<K>) {
+        // -0.0 and 0.0 compare equal, so they must map to the same key to keep the sort stable.
+        if(key == K(0))
+          key = K(0);
+        auto const bits = std::bit_cast<U>(key);
+        constexpr auto sign = U(1) << (sizeof(U) * 8 - 1);
+        return (bits & sign) ? U(~bits) : U(bits | sign);
+      } else if constexpr(std::is_signed_v<K>) {
+        constexpr auto sign = U(1) << (sizeof(U) * 8 - 1);
+        return U(U(key) ^ sign);
+      } else {
+        return U(key);
+      }
+    }
+
+    template<typename U>
+    struct radix_entry
+    {
+      U key;
+      std::size_t index;
+    };
+
+    /** LSD radix sort of 'entries' on 8 bits per pass.
+     * Passes where every key has the same digit are skipped.
+     */
+    template<typename U>
+    void radix_sort_entries(std::vector<radix_entry<U>> & entries)
+    {
+      constexpr auto passes = sizeof(U);
+      auto const size = entries.size();
+
+      std::array<std::array<std::size_t, 256>, passes> counts {};
+      for(auto const & entry : entries)
+        for(std::size_t pass = 0; pass < passes; ++pass)
+          ++counts[pass][(entry.key >> (pass * 8)) & 0xff];
+
+      auto buffer = std::vector<radix_entry<U>>(size);
+      auto * from = &entries;
+      auto * to = &buffer;
+
+      for(std::size_t pass = 0; pass < passes; ++pass) {
+        auto & count = counts[pass];
+        if(std::ranges::find(count, size) != count.end())
+          continue;
+
+        std::size_t offset = 0;
+        for(auto & c : count)
+          offset += std::exchange(c, offset);
+
+        for(auto const & entry : *from)
+          (*to)[count[(entry.key >> (pass * 8)) & 0xff]++] = entry;
+        std::swap(from, to);
+      }
+
+      if(from != &entries)
+        entries.swap(buffer);
+    }
+
+    template<typename R, typename M>
+    void radix_sort_by(R && range, M member)
+    {
+      using U = radix_key_t<sort_key_t<M>>;
+      using value_type = std::ranges::range_value_t<R>;
+
+      auto const first = std::ranges::begin(range);
+      auto const size = static_cast<std::size_t>(std::ranges::size(range));
+
+      auto entries = std::vector<radix_entry<U>>();
+      entries.reserve(size);
+      for(std::size_t i = 0; i < size; ++i)
+        entries.push_back({to_radix_key(std::invoke(member, first[i])), i});
+
+      radix_sort_entries(entries);
+
+      auto sorted = std::vector<value_type>();
+      sorted.reserve(size);
+      for(auto const & entry : entries)
+        sorted.push_back(std::ranges::iter_move(first + entry.index));
+      std::ranges::move(sorted, first);
+    }
+
+    template<bool Stable, typename R, typename M>
+    void sort_by(R && range, M member)
+    {
+      if constexpr(is_radix_sortable_v<sort_key_t<M>> &&
+                   std::move_constructible<std::ranges::range_value_t<R>>) {
+        if(std::ranges::size(range) >= radix_sort_threshold) {
+          radix_sort_by(range, member);
+          return;
+        }
+      }
+
+      if constexpr(Stable)
+        std::ranges::stable_sort(range, std::ranges::less {}, member);
+      else
+        std::ranges::sort(range, std::ranges::less {}, member);
+    }
+  } // namespace invocable_impl
+
+  /** Sorts 'range' in ascending order of the member pointed to by 'member'.
+   * Integral, enumeration and floating point keys are sorted with an LSD radix sort.
+   */
+  template<typename R, typename M>
+    requires sortable_by_member<R, M>
+  void sort_by(R && range, M member)
+  {
+    invocable_impl::sort_by<false>(range, member);
+  }
+
+  /** Like sort_by, but preserves the relative order of elements with equal keys.
+   */
+  template<typename R, typename M>
+    requires sortable_by_member<R, M>
+  void stable_sort_by(R && range, M member)
+  {
+    invocable_impl::sort_by<true>(range, member);
+  }
+
+  /** A run of consecutive elements sharing the same key.
+   */
+  template<typename Key, typename Iter>
+  struct member_group
+  {
+    Key key;
+    std::ranges::subrange<Iter> elements;
+  };
+
+  /** Stable sorts 'range' by the member pointed to by 'member', and returns the runs of elements
+   * with equal keys in ascending key order.
+   */
+  template<typename R, typename M>
+    requires sortable_by_member<R, M>
+  auto group_by(R && range, M member)
+      -> std::vector<member_group<invocable_impl::sort_key_t<M>, std::ranges::iterator_t<R>>>
+  {
+    stable_sort_by(range, member);
+
+    auto groups =
+        std::vector<member_group<invocable_impl::sort_key_t<M>, std::ranges::iterator_t<R>>>();
+    auto first = std::ranges::begin(range);
+    auto const last = std::ranges::end(range);
+
+    while(first != last) {
+      auto const & key = std::invoke(member, *first);
+      auto next = std::ranges::find_if_not(
+          first, last, [&](auto const & k) { return k == key; }, member);
+      groups.push_back({key, {first, next}});
+      first = next;
+    }
+
+    return groups;
+  }
+
+} // namespace ruby::inv
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+  // clang-format off
+
+  /** A handler of a static_event_bus: its first parameter, decayed, is the event it handles. */
+  template<typename H>
+  concept event_handler =
+    std::is_object_v<H> &&
+    invoke_deducible<H> &&
+    !std::is_member_pointer_v<H> &&
+    (invocable_arity_v<H> > 0) &&
+    !std::is_rvalue_reference_v<invocable_arg_t<H, 0>>;
+
+  // clang-format on
+
+  /** The event type handled by 'H'. */
+  template<event_handler H>
+  using handled_event_t = std::decay_t<invocable_arg_t<H, 0>>;
+
+  /**
+   * Publish/subscribe over a set of handlers known at compile time.
+   * Handlers are grouped by handled_event_t, so publish(event) expands to direct calls to the
+   * handlers of exactly that event type, in the order they were given, with no lookup and no
+   * type erasure. The event is passed to each of them as an lvalue, followed by as many of the
+   * extra arguments of publish as the handler has further parameters. A const event skips the
+   * handlers that take it by non-const reference.
+   */
+  template<event_handler... Handlers>
+  class static_event_bus
+  {
+    using handlers_type = std::tuple<Handlers...>;
+
+    handlers_type m_handlers;
+
+    /** 'Handler' handles 'Event', and its event parameter binds to an 'Event' lvalue: a
+     * handler taking a non-const reference does not receive const events.
+     */
+    template<typename Handler, typename Event>
+    static constexpr bool handles_v =
+        std::same_as<handled_event_t<Handler>, std::remove_cv_t<Event>> &&
+        std::is_convertible_v<Event &, invocable_arg_t<Handler, 0>>;
+
+    template<typename Event, std::size_t... I>
+    static constexpr std::size_t count_subscribers(std::index_sequence<I...>) noexcept
+    {
+      return (std::size_t(0) + ... +
+              std::size_t(handles_v<std::tuple_element_t<I, handlers_type>, Event>));
+    }
+
+    template<typename Handler, typename Event, typename Args, std::size_t... J>
+    static constexpr bool invocable_with(std::index_sequence<J...>) noexcept
+    {
+      return std::invocable<Handler &, Event &, std::tuple_element_t<J, Args>...>;
+    }
+
+    /** 'Handler' does not handle 'Event', or takes the leading published 'Args' it has
+     * parameters for.
+     */
+    template<typename Handler, typename Event, typename... Args>
+    static constexpr bool accepts() noexcept
+    {
+      if constexpr(!handles_v<Handler, Event>) {
+        return true;
+      } else {
+        constexpr auto extra = invocable_arity_v<Handler> - 1;
+        if constexpr(extra > sizeof...(Args))
+          return false;
+        else
+          return invocable_with<Handler, Event, std::tuple<Args &...>>(
+              std::make_index_sequence<extra>());
+      }
+    }
+
+    template<typename Handler, typename Event, typename Args, std::size_t... J>
+    static constexpr void call(Handler & handler, Event & event, Args & args,
+                               std::index_sequence<J...>)
+    {
+      std::invoke(handler, event, std::get<J>(args)...);
+    }
+
+    template<std::size_t I, typename Event, typename Args>
+    constexpr void deliver(Event & event, Args & args)
+    {
+      using handler = std::tuple_element_t<I, handlers_type>;
+      if constexpr(handles_v<handler, Event>)
+        call(std::get<I>(m_handlers), event, args,
+             std::make_index_sequence<invocable_arity_v<handler> - 1>());
+    }
+
+    template<typename Event, typename Args, std::size_t... I>
+    constexpr void publish_each(std::index_sequence<I...>, Event & event, Args & args)
+    {
+      (deliver<I>(event, args), ...);
+    }
+
+  public:
+    /** Number of handlers receiving events of type 'Event', which may be const. */
+    template<typename Event>
+    static constexpr std::size_t subscribers =
+        count_subscribers<std::remove_reference_t<Event>>(std::index_sequence_for<Handlers...>());
+
+    constexpr explicit static_event_bus(Handlers... handlers)
+      : m_handlers(std::move(handlers)...)
+    {}
+
+    /** Calls every handler of 'Event' with 'event' and the leading 'args' it takes. Events
+     * nobody handles are ignored, see subscribers. Every handler of 'Event' must accept the
+     * published arguments, so publishing too few or mismatched ones does not compile.
+     */
+    template<typename Event, typename... Args>
+      requires(accepts<Handlers, std::remove_reference_t<Event>, Args...>() && ...)
+    constexpr void publish(Event && event, Args &&... args)
+    {
+      auto extra = std::forward_as_tuple(args...);
+      publish_each(std::index_sequence_for<Handlers...>(), event, extra);
+    }
+
+    template<std::size_t I>
+    constexpr auto & handler() noexcept
+    {
+      return std::get<I>(m_handlers);
+    }
+
+    template<std::size_t I>
+    constexpr auto const & handler() const noexcept
+    {
+      return std::get<I>(m_handlers);
+    }
+  };
+
+  template<typename... Handlers>
+  static_event_bus(Handlers...) -> static_event_bus<Handlers...>;
+
+} // namespace ruby::inv
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ruby::inv
+{
+  /** Callables up to this size, with at most fundamental alignment and a non-throwing move
+   * constructor, are stored inside a task instead of being allocated.
+   */
+  inline constexpr std::size_t task_inline_size = 6 * sizeof(void *);
+
+  class task;
+
+  namespace invocable_impl
+  {
+    template<typename F>
+    inline constexpr bool is_task_inline_v = sizeof(F) <= task_inline_size &&
+                                             alignof(F) <= alignof(std::max_align_t) &&
+                                             std::is_nothrow_move_constructible_v<F>;
+
+    using relocate_fn = void (*)(std::byte * from, std::byte * to) noexcept;
+    using destroy_fn = void (*)(std::byte * storage) noexcept;
+
+    /** Storage operations that do not depend on the stored type: one copy of each serves every
+     * callable type they apply to, instead of one instantiation per type.
+     */
+    inline void relocate_bytes(std::byte * from, std::byte * to) noexcept
+    {
+      std::memcpy(to, from, task_inline_size);
+    }
+
+    inline void relocate_pointer(std::byte * from, std::byte * to) noexcept
+    {
+      std::memcpy(to, from, sizeof(void *));
+    }
+
+    inline void destroy_nothing(std::byte *) noexcept
+    {}
+
+    template<typename F>
+    F & inline_object(std::byte * storage) noexcept
+    {
+      return *std::launder(reinterpret_cast<F *>(storage));
+    }
+
+    template<typename F>
+    F *& heap_object(std::byte * storage) noexcept
+    {
+      return *std::launder(reinterpret_cast<F **>(storage));
+    }
+
+    template<typename F>
+    void relocate_inline(std::byte * from, std::byte * to) noexcept
+    {
+      ::new(static_cast<void *>(to)) F(std::move(inline_object<F>(from)));
+      std::destroy_at(&inline_object<F>(from));
+    }
+
+    template<typename F>
+    void destroy_inline(std::byte * storage) noexcept
+    {
+      std::destroy_at(&inline_object<F>(storage));
+    }
+
+    template<typename F>
+    void destroy_heap(std::byte * storage) noexcept
+    {
+      delete heap_object<F>(storage);
+    }
+
+    /** Trivially copyable callables stored inline are relocated by copying the storage. */
+    template<typename F>
+    constexpr relocate_fn inline_relocate() noexcept
+    {
+      if constexpr(std::is_trivially_copyable_v<F>)
+        return &relocate_bytes;
+      else
+        return &relocate_inline<F>;
+    }
+
+    template<typename F>
+    constexpr destroy_fn inline_destroy() noexcept
+    {
+      if constexpr(std::is_trivially_destructible_v<F>)
+        return &destroy_nothing;
+      else
+        return &destroy_inline<F>;
+    }
+
+    struct task_vtable
+    {
+      void (*run)(std::byte * storage);
+      relocate_fn relocate;
+      destroy_fn destroy;
+    };
+
+    template<typename F>
+    struct task_inline_vtable
+    {
+      static constexpr auto value = task_vtable {
+          [](std::byte * storage) { std::invoke(std::move(inline_object<F>(storage))); },
+          inline_relocate<F>(),
+          inline_destroy<F>()};
+    };
+
+    template<typename F>
+    struct task_heap_vtable
+    {
+      static constexpr auto value = task_vtable {
+          [](std::byte * storage) { std::invoke(std::move(*heap_object<F>(storage))); },
+          &relocate_pointer,
+          &destroy_heap<F>};
+    };
+  } // namespace invocable_impl
+
+  /**
+   * Move-only, call-once, type-erased nullary callable.
+   * Small callables are stored inline, larger ones are allocated. Calling a task invokes the
+   * callable as an rvalue and destroys it, leaving the task empty.
+   */
+  class task
+  {
+    alignas(std::max_align_t) std::byte m_storage[task_inline_size];
+    invocable_impl::task_vtable const * m_vtable = nullptr;
+
+    void reset() noexcept
+    {
+      if(m_vtable)
+        std::exchange(m_vtable, nullptr)->destroy(m_storage);
+    }
+
+  public:
+    task() noexcept = default;
+
+    template<typename F>
+      requires(!std::same_as<std::decay_t<F>, task>) && std::invocable<std::decay_t<F>>
+    task(F && fn)
+    {
+      using T = std::decay_t<F>;
+      if constexpr(invocable_impl::is_task_inline_v<T>) {
+        ::new(static_cast<void *>(m_storage)) T(std::forward<F>(fn));
+        m_vtable = &invocable_impl::task_inline_vtable<T>::value;
+      } else {
+        ::new(static_cast<void *>(m_storage)) T *(new T(std::forward<F>(fn)));
+        m_vtable = &invocable_impl::task_heap_vtable<T>::value;
+      }
+    }
+
+    task(task && other) noexcept
+      : m_vtable(std::exchange(other.m_vtable, nullptr))
+    {
+      if(m_vtable)
+        m_vtable->relocate(other.m_storage, m_storage);
+    }
+
+    task & operator=(task && other) noexcept
+    {
+      if(this != &other) {
+        reset();
+        m_vtable = std::exchange(other.m_vtable, nullptr);
+        if(m_vtable)
+          m_vtable->relocate(other.m_storage, m_storage);
+      }
+      return *this;
+    }
+
+    ~task()
+    {
+      reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+      return m_vtable != nullptr;
+    }
+
+    /** Invokes the stored callable, which must exist, and destroys it. */
+    void operator()()
+    {
+      struct destroy_guard
+      {
+        task & self;
+
+        ~destroy_guard()
+        {
+          self.reset();
+        }
+      } guard {*this};
+
+      m_vtable->run(m_storage);
+    }
+  };
+
+} // namespace ruby::inv
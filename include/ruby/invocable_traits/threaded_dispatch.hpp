@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "./invocable_traits.hpp"
+
+/** RUBY_INV_HAS_MUSTTAIL is 1 when guaranteed tail calls are available.
+ * Define RUBY_INV_NO_MUSTTAIL to force the loop-based dispatch.
+ */
+#if !defined(RUBY_INV_NO_MUSTTAIL) && defined(__has_cpp_attribute)
+#if __has_cpp_attribute(clang::musttail)
+#define RUBY_INV_HAS_MUSTTAIL 1
+#define RUBY_INV_MUSTTAIL [[clang::musttail]]
+#endif
+#endif
+
+#ifndef RUBY_INV_HAS_MUSTTAIL
+#define RUBY_INV_HAS_MUSTTAIL 0
+#define RUBY_INV_MUSTTAIL
+#endif
+
+namespace ruby::inv
+{
+  // clang-format off
+
+  /** A handler of a threaded dispatch table: stateless, so that it can be called through a plain
+   * function pointer, and with a deducible signature.
+   */
+  template<typename H>
+  concept stateless_handler =
+    std::is_empty_v<H> &&
+    std::default_initializable<H> &&
+    invoke_deducible<H>;
+
+  // clang-format on
+
+  namespace invocable_impl
+  {
+    template<typename Signature, typename Decode, typename... Handlers>
+    struct threaded_table;
+
+    template<typename R, typename... Args, typename Decode, typename... Handlers>
+    struct threaded_table<R(Args...), Decode, Handlers...>
+    {
+      static_assert((!std::is_rvalue_reference_v<Args> && ...),
+                    "handlers of a run share their arguments, they cannot be rvalue references");
+
+      using function_pointer = R (*)(Args...);
+
+      static constexpr auto size = sizeof...(Handlers);
+
+      /** Tail calls require arguments and results that need no cleanup in the caller. */
+      static constexpr bool tail_calls =
+          RUBY_INV_HAS_MUSTTAIL &&
+          (std::is_void_v<R> || std::is_trivially_destructible_v<R>) &&
+          ((std::is_trivially_copyable_v<Args> && std::is_trivially_destructible_v<Args>) && ...);
+
+      static std::size_t decode(Args &... args)
+      {
+        return static_cast<std::size_t>(Decode {}(args...));
+      }
+
+      template<typename H>
+      static R step(Args... args)
+      {
+        return H {}(args...);
+      }
+
+      /** Runs 'H', then jumps straight to the handler of the next opcode. */
+      template<typename H>
+      static R threaded_step(Args... args)
+      {
+        if constexpr(std::is_void_v<R>) {
+          H {}(args...);
+          auto const next = decode(args...);
+          if(next >= size)
+            return;
+          RUBY_INV_MUSTTAIL return threaded_handlers[next](args...);
+        } else {
+          R result = H {}(args...);
+          auto const next = decode(args...);
+          if(next >= size)
+            return result;
+          RUBY_INV_MUSTTAIL return threaded_handlers[next](args...);
+        }
+      }
+
+      static constexpr std::array<function_pointer, size> handlers {&step<Handlers>...};
+      static constexpr std::array<function_pointer, size> threaded_handlers {
+          &threaded_step<Handlers>...};
+
+      /** Runs the handler at index 'opcode' once. */
+      static R dispatch(std::size_t opcode, Args... args)
+      {
+        return handlers[opcode](args...);
+      }
+
+      /** Runs handlers until 'Decode' returns an index past the last handler, and returns the
+       * result of the last handler run (a value-initialized result if none ran).
+       */
+      static R run(Args... args)
+      {
+        auto opcode = decode(args...);
+
+        if constexpr(tail_calls) {
+          if(opcode >= size)
+            return R();
+          return threaded_handlers[opcode](args...);
+        } else if constexpr(std::is_void_v<R>) {
+          for(; opcode < size; opcode = decode(args...))
+            handlers[opcode](args...);
+        } else {
+          auto result = R();
+          for(; opcode < size; opcode = decode(args...))
+            result = handlers[opcode](args...);
+          return result;
+        }
+      }
+    };
+
+    template<typename... Handlers>
+    using first_signature_t =
+        invocable_signature_t<std::tuple_element_t<0, std::tuple<Handlers...>>>;
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** All the handlers have the same signature after removing qualifiers. */
+  template<typename... Handlers>
+  concept same_signature =
+    (sizeof...(Handlers) > 0) &&
+    (invoke_deducible<Handlers> && ...) &&
+    (std::same_as<invocable_signature_t<Handlers>,
+                  invocable_impl::first_signature_t<Handlers...>> && ...);
+
+  // clang-format on
+
+  /**
+   * Type-checked plumbing for threaded interpreters.
+   * Every handler is stateless and has the same signature 'R(Args...)' after removing
+   * qualifiers. 'Decode' is stateless too, and maps the arguments to the index of the next
+   * handler to run, any index past the last handler halting the run.
+   * With [[clang::musttail]] each handler jumps directly to the next one through a guaranteed
+   * tail call; elsewhere, or when arguments need cleanup, run() falls back to a dispatch loop.
+   */
+  template<typename Decode, typename... Handlers>
+    requires same_signature<Handlers...> && (stateless_handler<Handlers> && ...) &&
+             std::is_empty_v<Decode> && std::default_initializable<Decode>
+  struct threaded_dispatch
+    : invocable_impl::threaded_table<invocable_impl::first_signature_t<Handlers...>,
+                                     Decode,
+                                     Handlers...>
+  {
+    using signature_type = invocable_impl::first_signature_t<Handlers...>;
+  };
+
+  /** Builds the dispatch table of 'handlers', where 'decode' selects the next handler. */
+  template<typename Decode, typename... Handlers>
+    requires same_signature<Handlers...> && (stateless_handler<Handlers> && ...) &&
+             std::is_empty_v<Decode> && std::default_initializable<Decode>
+  constexpr auto make_threaded_dispatch(Decode, Handlers...) noexcept
+      -> threaded_dispatch<Decode, Handlers...>
+  {
+    return {};
+  }
+
+} // namespace ruby::inv
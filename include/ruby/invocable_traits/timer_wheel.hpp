@@ -0,0 +1,320 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./invocable_traits.hpp"
+#include "./task.hpp"
+
+namespace ruby::inv
+{
+  // clang-format off
+
+  /** A callback a timer_wheel can run: a deducible callable whose function type
+   * (invocable_function_t) takes no arguments. Its result, if any, is discarded.
+   */
+  template<typename F>
+  concept timer_callback =
+    std::is_object_v<F> &&
+    invoke_deducible<F> &&
+    !std::is_member_pointer_v<F> &&
+    (function_arity_v<invocable_function_t<F>> == 0) &&
+    !function_is_variadic_v<invocable_function_t<F>> &&
+    std::invocable<F>;
+
+  // clang-format on
+
+  /** Identifies a timer scheduled on a timer_wheel. Stale ids are detected, not reused. */
+  struct timer_id
+  {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+
+    friend constexpr bool operator==(timer_id, timer_id) noexcept = default;
+  };
+
+  /**
+   * Hashed hierarchical timer wheel over an abstract tick counter.
+   * Four levels of 256 slots cover 2^32 ticks ahead of now(); a timer is placed on the lowest
+   * level whose slot span contains its deadline, and moves down one or more levels when now()
+   * enters that slot. Later deadlines wait on an overflow list, revisited every 2^32 ticks.
+   * Timers are nodes of a pooled, index-linked list, so schedule() and cancel() are O(1) and
+   * allocate nothing once the pool has grown, and callbacks up to task_inline_size bytes are
+   * stored inline in their node.
+   * advance_to() visits only occupied slots, found through a bitmap per level, and runs the
+   * expired callbacks in batches, slot by slot, in deadline order and, for equal deadlines,
+   * in schedule order. Callbacks may schedule and cancel timers.
+   */
+  class timer_wheel
+  {
+    static constexpr std::size_t levels = 4;
+    static constexpr std::size_t level_bits = 8;
+    static constexpr std::size_t slots = std::size_t(1) << level_bits;
+    static constexpr std::size_t overflow = levels * slots;
+    static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint16_t unlinked = std::numeric_limits<std::uint16_t>::max();
+
+    struct node
+    {
+      task callback;
+      std::uint64_t deadline = 0;
+      std::uint32_t prev = nil;
+      std::uint32_t next = nil;
+      std::uint32_t generation = 0;
+      std::uint16_t list = unlinked;
+    };
+
+    std::vector<node> m_nodes;
+    std::uint32_t m_free = nil;
+    std::size_t m_size = 0;
+    std::uint64_t m_now = 0;
+    std::array<std::uint32_t, overflow + 1> m_heads;
+    std::array<std::uint32_t, overflow + 1> m_tails;
+    std::array<std::array<std::uint64_t, slots / 64>, levels> m_occupied {};
+
+    static constexpr std::uint64_t span(std::size_t level) noexcept
+    {
+      return std::uint64_t(1) << (level * level_bits);
+    }
+
+    static constexpr std::size_t slot_of(std::uint64_t time, std::size_t level) noexcept
+    {
+      return static_cast<std::size_t>(time >> (level * level_bits)) & (slots - 1);
+    }
+
+    /** The list holding deadline 'deadline', which must not be earlier than now(). */
+    std::size_t list_of(std::uint64_t deadline) const noexcept
+    {
+      for(std::size_t level = 0; level < levels; ++level) {
+        auto const shift = (level + 1) * level_bits;
+        if((deadline >> shift) == (m_now >> shift))
+          return level * slots + slot_of(deadline, level);
+      }
+      return overflow;
+    }
+
+    void mark(std::size_t list, bool occupied) noexcept
+    {
+      if(list == overflow)
+        return;
+      auto & word = m_occupied[list / slots][(list % slots) / 64];
+      auto const bit = std::uint64_t(1) << (list % 64);
+      word = occupied ? word | bit : word & ~bit;
+    }
+
+    /** Appends the timer to its list, so timers with equal deadlines run in schedule order. */
+    void link(std::uint32_t index)
+    {
+      auto & n = m_nodes[index];
+      auto const list = list_of(n.deadline);
+      n.list = static_cast<std::uint16_t>(list);
+      n.next = nil;
+      n.prev = m_tails[list];
+      if(n.prev != nil)
+        m_nodes[n.prev].next = index;
+      else {
+        m_heads[list] = index;
+        mark(list, true);
+      }
+      m_tails[list] = index;
+    }
+
+    void unlink(std::uint32_t index) noexcept
+    {
+      auto & n = m_nodes[index];
+      if(n.prev != nil)
+        m_nodes[n.prev].next = n.next;
+      else
+        m_heads[n.list] = n.next;
+      if(n.next != nil)
+        m_nodes[n.next].prev = n.prev;
+      else
+        m_tails[n.list] = n.prev;
+      if(m_heads[n.list] == nil)
+        mark(n.list, false);
+      n.list = unlinked;
+    }
+
+    void release(std::uint32_t index) noexcept
+    {
+      auto & n = m_nodes[index];
+      ++n.generation;
+      n.next = m_free;
+      m_free = index;
+      --m_size;
+    }
+
+    /** Moves every timer of 'list' to the list its deadline now belongs to. */
+    void cascade(std::size_t list)
+    {
+      auto index = std::exchange(m_heads[list], nil);
+      m_tails[list] = nil;
+      mark(list, false);
+      while(index != nil) {
+        auto const next = m_nodes[index].next;
+        link(index);
+        index = next;
+      }
+    }
+
+    /** The first tick after now() where a slot holding timers is reached, or max. */
+    std::uint64_t next_event() const noexcept
+    {
+      for(std::size_t level = 0; level < levels; ++level) {
+        auto const current = slot_of(m_now, level);
+        auto const & words = m_occupied[level];
+        for(auto word = (current + 1) / 64; word < words.size(); ++word) {
+          auto bits = words[word];
+          if(word == (current + 1) / 64)
+            bits &= ~std::uint64_t(0) << ((current + 1) % 64);
+          if(bits != 0) {
+            auto const slot = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            auto const block = m_now >> ((level + 1) * level_bits) << ((level + 1) * level_bits);
+            return block + slot * span(level);
+          }
+        }
+      }
+      if(m_heads[overflow] != nil)
+        return ((m_now >> (levels * level_bits)) + 1) << (levels * level_bits);
+      return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    /** Runs the timers expiring at now(), which all wait in one level 0 slot. */
+    std::size_t expire()
+    {
+      auto const list = slot_of(m_now, 0);
+      std::size_t fired = 0;
+      while(m_heads[list] != nil) {
+        auto const index = m_heads[list];
+        unlink(index);
+        auto callback = std::move(m_nodes[index].callback);
+        release(index);
+        ++fired;
+        callback();
+      }
+      return fired;
+    }
+
+    std::uint32_t acquire()
+    {
+      if(m_free != nil) {
+        auto const index = m_free;
+        m_free = m_nodes[index].next;
+        return index;
+      }
+      m_nodes.emplace_back();
+      return static_cast<std::uint32_t>(m_nodes.size() - 1);
+    }
+
+  public:
+    timer_wheel() noexcept
+    {
+      m_heads.fill(nil);
+      m_tails.fill(nil);
+    }
+
+    /** Creates a wheel whose pool already holds 'capacity' timers. */
+    explicit timer_wheel(std::size_t capacity)
+      : timer_wheel()
+    {
+      reserve(capacity);
+    }
+
+    void reserve(std::size_t capacity)
+    {
+      m_nodes.reserve(capacity);
+    }
+
+    /** The current tick. */
+    std::uint64_t now() const noexcept
+    {
+      return m_now;
+    }
+
+    /** Number of pending timers. */
+    std::size_t size() const noexcept
+    {
+      return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+    /** Runs 'fn' when now() reaches 'deadline', or at the next tick if it already has. */
+    template<typename F>
+      requires timer_callback<std::decay_t<F>>
+    timer_id schedule_at(std::uint64_t deadline, F && fn)
+    {
+      auto callback = task(std::forward<F>(fn));
+      auto const index = acquire();
+      auto & n = m_nodes[index];
+      n.callback = std::move(callback);
+      n.deadline = deadline > m_now ? deadline : m_now + 1;
+      link(index);
+      ++m_size;
+      return {index, n.generation};
+    }
+
+    /** Runs 'fn' 'delay' ticks from now(), at least one. */
+    template<typename F>
+      requires timer_callback<std::decay_t<F>>
+    timer_id schedule(std::uint64_t delay, F && fn)
+    {
+      return schedule_at(m_now + delay, std::forward<F>(fn));
+    }
+
+    /** True if 'id' is scheduled and has neither expired nor been cancelled. */
+    bool pending(timer_id id) const noexcept
+    {
+      return id.index < m_nodes.size() && m_nodes[id.index].generation == id.generation &&
+             m_nodes[id.index].list != unlinked;
+    }
+
+    /** Cancels the timer 'id', destroying its callback. Returns false if it was not pending. */
+    bool cancel(timer_id id) noexcept
+    {
+      if(!pending(id))
+        return false;
+      unlink(id.index);
+      m_nodes[id.index].callback = task();
+      release(id.index);
+      return true;
+    }
+
+    /** Advances to tick 'time', running every timer expiring up to it in deadline order.
+     * Returns the number of callbacks run.
+     */
+    std::size_t advance_to(std::uint64_t time)
+    {
+      std::size_t fired = 0;
+      for(auto event = next_event(); event <= time; event = next_event()) {
+        m_now = event;
+        if((m_now & (span(levels) - 1)) == 0)
+          cascade(overflow);
+        for(auto level = levels - 1; level > 0; --level)
+          if((m_now & (span(level) - 1)) == 0)
+            cascade(level * slots + slot_of(m_now, level));
+        fired += expire();
+      }
+      if(time > m_now)
+        m_now = time;
+      return fired;
+    }
+
+    /** Advances by 'ticks', see advance_to. */
+    std::size_t advance(std::uint64_t ticks)
+    {
+      return advance_to(m_now + ticks);
+    }
+  };
+
+} // namespace ruby::inv
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <concepts>
+#include <exception>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+#ifndef __cpp_lib_expected
+#include <variant>
+#endif
+
+#include "./invocable_traits.hpp"
+
+namespace ruby::inv
+{
+#ifdef __cpp_lib_expected
+  template<typename T, typename E>
+  using expected = std::expected<T, E>;
+
+  template<typename E>
+  using unexpected = std::unexpected<E>;
+
+  template<typename E>
+  using bad_expected_access = std::bad_expected_access<E>;
+#else
+  /** Before C++23: the subset of std::expected used by to_expected, with the same names. */
+  template<typename E>
+  class unexpected
+  {
+    E m_error;
+
+  public:
+    constexpr explicit unexpected(E error)
+      : m_error(std::move(error))
+    {}
+
+    constexpr E & error() & noexcept
+    {
+      return m_error;
+    }
+
+    constexpr E const & error() const & noexcept
+    {
+      return m_error;
+    }
+
+    constexpr E && error() && noexcept
+    {
+      return std::move(m_error);
+    }
+  };
+
+  template<typename E>
+  class bad_expected_access : public std::exception
+  {
+    E m_error;
+
+  public:
+    explicit bad_expected_access(E error)
+      : m_error(std::move(error))
+    {}
+
+    char const * what() const noexcept override
+    {
+      return "bad access to expected without value";
+    }
+
+    E const & error() const & noexcept
+    {
+      return m_error;
+    }
+  };
+
+  template<typename T, typename E>
+  class expected
+  {
+    using stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    std::variant<stored, E> m_storage;
+
+  public:
+    using value_type = T;
+    using error_type = E;
+
+    constexpr expected()
+        requires std::default_initializable<stored>
+      : m_storage(std::in_place_index<0>)
+    {}
+
+    template<typename U = stored>
+      requires(!std::is_void_v<T> && std::constructible_from<T, U> &&
+               !std::same_as<std::remove_cvref_t<U>, expected>)
+    constexpr expected(U && value)
+      : m_storage(std::in_place_index<0>, std::forward<U>(value))
+    {}
+
+    template<typename G>
+      requires std::constructible_from<E, G>
+    constexpr expected(unexpected<G> error)
+      : m_storage(std::in_place_index<1>, std::move(error).error())
+    {}
+
+    constexpr bool has_value() const noexcept
+    {
+      return m_storage.index() == 0;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+      return has_value();
+    }
+
+    template<typename U = T>
+      requires(!std::is_void_v<U>)
+    constexpr U & operator*() & noexcept
+    {
+      return *std::get_if<0>(&m_storage);
+    }
+
+    template<typename U = T>
+      requires(!std::is_void_v<U>)
+    constexpr U const & operator*() const & noexcept
+    {
+      return *std::get_if<0>(&m_storage);
+    }
+
+    template<typename U = T>
+      requires(!std::is_void_v<U>)
+    constexpr U && operator*() && noexcept
+    {
+      return std::move(*std::get_if<0>(&m_storage));
+    }
+
+    template<typename U = T>
+      requires(!std::is_void_v<U>)
+    constexpr U * operator->() noexcept
+    {
+      return std::get_if<0>(&m_storage);
+    }
+
+    constexpr decltype(auto) value() &
+    {
+      if(!has_value())
+        throw bad_expected_access<E>(error());
+      if constexpr(!std::is_void_v<T>)
+        return **this;
+    }
+
+    constexpr decltype(auto) value() &&
+    {
+      if(!has_value())
+        throw bad_expected_access<E>(error());
+      if constexpr(!std::is_void_v<T>)
+        return std::move(**this);
+    }
+
+    constexpr E & error() & noexcept
+    {
+      return *std::get_if<1>(&m_storage);
+    }
+
+    constexpr E const & error() const & noexcept
+    {
+      return *std::get_if<1>(&m_storage);
+    }
+  };
+#endif
+
+  template<typename F, typename E>
+  class expected_call;
+
+  namespace invocable_impl
+  {
+    /** Gives expected_call the call operator 'R(Args...) noexcept', see chain_call. */
+    template<typename Derived, typename R, typename Args>
+    struct expected_call_operator;
+
+    template<typename Derived, typename R, typename... Args>
+    struct expected_call_operator<Derived, R, std::tuple<Args...>>
+    {
+      R operator()(Args... args) noexcept
+      {
+        return static_cast<Derived &>(*this).call(std::forward<Args>(args)...);
+      }
+    };
+
+    template<typename R, typename E, typename F, typename... Args>
+    expected<R, E> invoke_expected(F & fn, Args &&... args)
+    {
+      if constexpr(std::is_void_v<R>) {
+        std::invoke(fn, std::forward<Args>(args)...);
+        return {};
+      } else {
+        return expected<R, E>(std::invoke(fn, std::forward<Args>(args)...));
+      }
+    }
+  } // namespace invocable_impl
+
+  // clang-format off
+
+  /** A callable to_expected can wrap: a deducible callable that is not variadic and returns
+   * an object type or void.
+   */
+  template<typename F>
+  concept expected_wrappable =
+    std::is_object_v<F> &&
+    invoke_deducible<F> &&
+    !invocable_is_variadic_v<F> &&
+    (std::is_object_v<invocable_ret_t<F>> || std::is_void_v<invocable_ret_t<F>>);
+
+  // clang-format on
+
+  /**
+   * Calls 'F' and returns its result as an expected<invocable_ret_t<F>, E>; the call operator is
+   * noexcept, and has the arguments of 'F', so the wrapper is itself invoke_deducible.
+   * With E = std::exception_ptr every exception is caught and returned as the error. With any
+   * other E, only exceptions of type E are caught, and others reach the noexcept boundary and
+   * terminate. When 'F' is already noexcept there is nothing to catch: the result is returned
+   * without any handler.
+   */
+  template<typename F, typename E>
+  class expected_call
+    : public invocable_impl::expected_call_operator<expected_call<F, E>,
+                                                    expected<invocable_ret_t<F>, E>,
+                                                    invocable_args_t<F>>
+  {
+    template<typename, typename, typename>
+    friend struct invocable_impl::expected_call_operator;
+
+    F m_fn;
+
+    template<typename... Args>
+    expected<invocable_ret_t<F>, E> call(Args &&... args) noexcept
+    {
+      using R = invocable_ret_t<F>;
+      if constexpr(invocable_is_noexcept_v<F>) {
+        return invocable_impl::invoke_expected<R, E>(m_fn, std::forward<Args>(args)...);
+      } else if constexpr(std::same_as<E, std::exception_ptr>) {
+        try {
+          return invocable_impl::invoke_expected<R, E>(m_fn, std::forward<Args>(args)...);
+        } catch(...) {
+          return unexpected<E>(std::current_exception());
+        }
+      } else {
+        try {
+          return invocable_impl::invoke_expected<R, E>(m_fn, std::forward<Args>(args)...);
+        } catch(E & error) {
+          return unexpected<E>(std::move(error));
+        }
+      }
+    }
+
+  public:
+    using function_type = F;
+    using error_type = E;
+    using result_type = expected<invocable_ret_t<F>, E>;
+
+    explicit expected_call(F fn)
+      : m_fn(std::move(fn))
+    {}
+
+    F & function() noexcept
+    {
+      return m_fn;
+    }
+
+    F const & function() const noexcept
+    {
+      return m_fn;
+    }
+  };
+
+  /** Wraps 'fn' into an expected_call returning errors of type 'E'. */
+  template<typename E = std::exception_ptr, typename F>
+    requires expected_wrappable<std::decay_t<F>> && std::is_object_v<E>
+  auto to_expected(F && fn)
+  {
+    return expected_call<std::decay_t<F>, E>(std::forward<F>(fn));
+  }
+
+} // namespace ruby::inv
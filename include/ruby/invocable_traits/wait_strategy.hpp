@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace ruby::inv
+{
+  /** Size used to keep independently written atomics on separate cache lines.
+   */
+  inline constexpr std::size_t cache_line_size = 64;
+
+  namespace invocable_impl
+  {
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#elif defined(__aarch64__)
+      asm volatile("yield");
+#endif
+    }
+  } // namespace invocable_impl
+
+  /**
+   * A wait strategy blocks a thread until a condition, published by another thread, becomes true.
+   * wait_until(ready) returns once ready() is true, notify() is called by the publishing thread
+   * after making the condition true, and wake() unblocks waiters so they can re-check an
+   * external condition such as a stop request.
+   */
+
+  /** Busy waits, lowest latency and full use of a core while waiting. */
+  struct spin_wait
+  {
+    template<typename Pred>
+    void wait_until(Pred ready) noexcept(noexcept(ready()))
+    {
+      while(!ready())
+        invocable_impl::cpu_relax();
+    }
+
+    void notify() noexcept
+    {}
+
+    void wake() noexcept
+    {}
+  };
+
+  /** Polls the condition, yielding the time slice between polls. */
+  struct yield_wait
+  {
+    template<typename Pred>
+    void wait_until(Pred ready) noexcept(noexcept(ready()))
+    {
+      while(!ready())
+        std::this_thread::yield();
+    }
+
+    void notify() noexcept
+    {}
+
+    void wake() noexcept
+    {}
+  };
+
+  /** Spins briefly, then sleeps on an atomic wait (a futex on Linux).
+   * notify() only costs a fence and a load when nobody is sleeping.
+   */
+  class futex_wait
+  {
+    static constexpr int spin_count = 64;
+
+    std::atomic<std::uint32_t> m_epoch {0};
+    std::atomic<std::uint32_t> m_sleepers {0};
+
+  public:
+    template<typename Pred>
+    void wait_until(Pred ready) noexcept(noexcept(ready()))
+    {
+      for(int i = 0; i < spin_count; ++i) {
+        if(ready())
+          return;
+        invocable_impl::cpu_relax();
+      }
+
+      while(!ready()) {
+        auto const epoch = m_epoch.load(std::memory_order_acquire);
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if(!ready())
+          m_epoch.wait(epoch, std::memory_order_acquire);
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+
+    void notify() noexcept
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(m_sleepers.load(std::memory_order_relaxed) != 0)
+        wake();
+    }
+
+    void wake() noexcept
+    {
+      m_epoch.fetch_add(1, std::memory_order_release);
+      m_epoch.notify_all();
+    }
+  };
+
+} // namespace ruby::inv
@@ -0,0 +1,609 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./invocable_traits.hpp"
+#include "./task.hpp"
+#include "./wait_strategy.hpp"
+
+namespace ruby::inv
+{
+  /** Capacity of the local deque of each worker. Tasks pushed to a full deque go to the
+   * global injection queue.
+   */
+  inline constexpr std::size_t worker_deque_capacity = 1024;
+
+  /** Number of released future states each thread keeps, per result type, for later submits.
+   */
+  inline constexpr std::size_t future_state_cache_size = 64;
+
+  class work_stealing_executor;
+
+  template<typename R>
+  class task_future;
+
+  namespace invocable_impl
+  {
+    /**
+     * Chase-Lev work-stealing deque with a fixed capacity.
+     * The owner pushes and pops at the bottom, thieves steal from the top. Tasks are stored in
+     * the slots themselves: whoever wins an index moves the task out and then releases the slot,
+     * and the owner treats a slot that is still being moved out of as full.
+     */
+    class work_stealing_deque
+    {
+      struct slot
+      {
+        task value;
+        std::atomic<bool> occupied {false};
+      };
+
+      std::int64_t m_mask;
+      std::unique_ptr<slot[]> m_slots;
+
+      alignas(cache_line_size) std::atomic<std::int64_t> m_top {0};
+      alignas(cache_line_size) std::atomic<std::int64_t> m_bottom {0};
+
+      void take(std::int64_t index, task & out) noexcept
+      {
+        auto & current = m_slots[index & m_mask];
+        out = std::move(current.value);
+        current.occupied.store(false, std::memory_order_release);
+      }
+
+    public:
+      explicit work_stealing_deque(std::size_t capacity)
+        : m_mask(static_cast<std::int64_t>(std::bit_ceil(capacity)) - 1)
+        , m_slots(std::make_unique<slot[]>(m_mask + 1))
+      {}
+
+      /** Owner only. */
+      bool try_push(task & value) noexcept
+      {
+        auto const bottom = m_bottom.load(std::memory_order_relaxed);
+        auto const top = m_top.load(std::memory_order_acquire);
+        if(bottom - top > m_mask)
+          return false;
+
+        auto & current = m_slots[bottom & m_mask];
+        if(current.occupied.load(std::memory_order_acquire))
+          return false;
+
+        current.value = std::move(value);
+        current.occupied.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+      }
+
+      /** Owner only. */
+      bool try_pop(task & out) noexcept
+      {
+        auto const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = m_top.load(std::memory_order_relaxed);
+
+        if(top > bottom) {
+          m_bottom.store(bottom + 1, std::memory_order_relaxed);
+          return false;
+        }
+
+        if(top == bottom) {
+          auto const won = m_top.compare_exchange_strong(
+              top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+          m_bottom.store(bottom + 1, std::memory_order_relaxed);
+          if(!won)
+            return false;
+        }
+
+        take(bottom, out);
+        return true;
+      }
+
+      bool try_steal(task & out) noexcept
+      {
+        auto top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto const bottom = m_bottom.load(std::memory_order_acquire);
+        if(top >= bottom)
+          return false;
+
+        if(!m_top.compare_exchange_strong(
+               top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+          return false;
+
+        take(top, out);
+        return true;
+      }
+
+      bool empty() const noexcept
+      {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+      }
+    };
+
+    struct worker
+    {
+      work_stealing_executor * executor;
+      futex_wait * idle;
+      std::size_t index;
+      work_stealing_deque deque;
+    };
+
+    inline thread_local worker * current_worker = nullptr;
+
+    enum class future_status : std::uint32_t
+    {
+      pending,
+      value,
+      exception
+    };
+
+    struct future_void
+    {};
+
+    template<typename R>
+    using future_storage_t = std::conditional_t<
+        std::is_void_v<R>,
+        future_void,
+        std::conditional_t<std::is_reference_v<R>, std::remove_reference_t<R> *, R>>;
+
+    template<typename F, typename Tuple>
+    inline constexpr bool is_nothrow_applicable_v = false;
+
+    /** Applying 'F' to the moved elements of the tuple, including the conversions of the
+     * arguments to the parameter types, cannot throw.
+     */
+    template<typename F, typename... Args>
+    inline constexpr bool is_nothrow_applicable_v<F, std::tuple<Args...>> =
+        std::is_nothrow_invocable_v<F, Args...>;
+
+    /**
+     * Per-thread free list of the storage of objects of size 'Size' and alignment 'Align'.
+     * Storage released on a thread is reused by the next allocation on that thread, and at most
+     * future_state_cache_size blocks are kept, so steady submit and get cycles do not reach the
+     * global allocator.
+     */
+    template<std::size_t Size, std::size_t Align>
+    class block_cache
+    {
+      struct node
+      {
+        node * next;
+      };
+
+      static_assert(Size >= sizeof(node) && Align >= alignof(node));
+
+      node * m_head = nullptr;
+      std::size_t m_size = 0;
+      bool m_closed = false;
+
+    public:
+      block_cache() noexcept = default;
+      block_cache(block_cache const &) = delete;
+      block_cache & operator=(block_cache const &) = delete;
+
+      /** Blocks released after the thread's cache is destroyed go to the global allocator. */
+      ~block_cache()
+      {
+        m_closed = true;
+        while(m_head)
+          ::operator delete(std::exchange(m_head, m_head->next), std::align_val_t(Align));
+      }
+
+      static block_cache & local() noexcept
+      {
+        thread_local block_cache cache;
+        return cache;
+      }
+
+      void * allocate()
+      {
+        if(!m_head)
+          return ::operator new(Size, std::align_val_t(Align));
+        --m_size;
+        return std::exchange(m_head, m_head->next);
+      }
+
+      void deallocate(void * block) noexcept
+      {
+        if(m_closed || m_size == future_state_cache_size) {
+          ::operator delete(block, std::align_val_t(Align));
+          return;
+        }
+        m_head = ::new(block) node {m_head};
+        ++m_size;
+      }
+    };
+
+    /** Shared between a task_future and the task that completes it, whichever finishes last
+     * deletes it. The storage comes from the block_cache of the allocating thread.
+     */
+    template<typename R>
+    struct future_state
+    {
+      std::atomic<future_status> status {future_status::pending};
+      std::atomic<std::uint32_t> references {2};
+      std::optional<future_storage_t<R>> value;
+      std::exception_ptr exception;
+
+      static auto & cache() noexcept
+      {
+        return block_cache<sizeof(future_state), alignof(future_state)>::local();
+      }
+
+      static void * operator new(std::size_t)
+      {
+        return cache().allocate();
+      }
+
+      static void operator delete(void * block) noexcept
+      {
+        cache().deallocate(block);
+      }
+
+      void release() noexcept
+      {
+        if(references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          delete this;
+      }
+
+      void complete(future_status result) noexcept
+      {
+        status.store(result, std::memory_order_release);
+        status.notify_all();
+      }
+
+      /** Neither the call nor storing its result can throw. */
+      template<typename F, typename Tuple>
+      static constexpr bool runs_nothrow_v =
+          is_nothrow_applicable_v<F, Tuple> &&
+          (std::is_void_v<R> || std::is_reference_v<R> || std::is_nothrow_move_constructible_v<R>);
+
+      template<typename F, typename Tuple>
+      void run(F & fn, Tuple & args) noexcept(runs_nothrow_v<F, Tuple>)
+      {
+        if constexpr(std::is_void_v<R>)
+          std::apply(std::move(fn), std::move(args));
+        else if constexpr(std::is_reference_v<R>)
+          value.emplace(std::addressof(std::apply(std::move(fn), std::move(args))));
+        else
+          value.emplace(std::apply(std::move(fn), std::move(args)));
+      }
+
+      /** Runs 'fn' and publishes its result. Exceptions are only caught when the call, the
+       * conversions of the arguments or the move of the result may throw.
+       */
+      template<typename F, typename Tuple>
+      void fulfill(F & fn, Tuple & args) noexcept
+      {
+        if constexpr(runs_nothrow_v<F, Tuple>) {
+          run(fn, args);
+          complete(future_status::value);
+        } else {
+          try {
+            run(fn, args);
+            complete(future_status::value);
+          } catch(...) {
+            exception = std::current_exception();
+            complete(future_status::exception);
+          }
+        }
+        release();
+      }
+    };
+
+    template<typename F, typename... Args>
+    struct bound_task
+    {
+      F fn;
+      std::tuple<Args...> args;
+
+      void operator()()
+      {
+        std::apply(std::move(fn), std::move(args));
+      }
+    };
+
+    template<typename R, typename F, typename... Args>
+    struct future_task
+    {
+      future_state<R> * state;
+      F fn;
+      std::tuple<Args...> args;
+
+      /** Helpers waiting for a future on a worker sleep on the idle wait of the executor. */
+      void operator()() noexcept
+      {
+        state->fulfill(fn, args);
+        if(auto * self = current_worker)
+          self->idle->notify();
+      }
+    };
+  } // namespace invocable_impl
+
+  /**
+   * Result of work_stealing_executor::submit.
+   * Waiting on a worker thread of the executor runs other pending tasks instead of blocking.
+   */
+  template<typename R>
+  class task_future
+  {
+    using state_type = invocable_impl::future_state<R>;
+
+    state_type * m_state = nullptr;
+
+    friend class work_stealing_executor;
+
+    explicit task_future(state_type * state) noexcept
+      : m_state(state)
+    {}
+
+  public:
+    using value_type = R;
+
+    task_future() noexcept = default;
+
+    task_future(task_future && other) noexcept
+      : m_state(std::exchange(other.m_state, nullptr))
+    {}
+
+    task_future & operator=(task_future && other) noexcept
+    {
+      if(this != &other) {
+        if(m_state)
+          m_state->release();
+        m_state = std::exchange(other.m_state, nullptr);
+      }
+      return *this;
+    }
+
+    ~task_future()
+    {
+      if(m_state)
+        m_state->release();
+    }
+
+    bool valid() const noexcept
+    {
+      return m_state != nullptr;
+    }
+
+    bool ready() const noexcept
+    {
+      return m_state->status.load(std::memory_order_acquire) !=
+             invocable_impl::future_status::pending;
+    }
+
+    void wait() const;
+
+    /** Waits for the result and returns it, rethrowing the exception of the task if any.
+     * The future is no longer valid afterwards.
+     */
+    R get()
+    {
+      wait();
+
+      struct release_guard
+      {
+        state_type * state;
+
+        ~release_guard()
+        {
+          state->release();
+        }
+      } guard {std::exchange(m_state, nullptr)};
+
+      if(guard.state->status.load(std::memory_order_relaxed) ==
+         invocable_impl::future_status::exception)
+        std::rethrow_exception(guard.state->exception);
+
+      if constexpr(std::is_void_v<R>)
+        return;
+      else if constexpr(std::is_reference_v<R>)
+        return static_cast<R>(**guard.state->value);
+      else
+        return std::move(*guard.state->value);
+    }
+  };
+
+  /**
+   * Thread pool where each worker owns a Chase-Lev deque and steals from the others when idle.
+   * Tasks submitted from a worker go to its own deque, tasks submitted from other threads go to
+   * a global injection queue. Idle workers sleep on a futex_wait.
+   * The destructor runs all pending tasks before joining the workers.
+   */
+  class work_stealing_executor
+  {
+    std::vector<std::unique_ptr<invocable_impl::worker>> m_workers;
+
+    alignas(cache_line_size) std::mutex m_injection_mutex;
+    std::deque<task> m_injected;
+    std::atomic<std::size_t> m_injected_size {0};
+
+    alignas(cache_line_size) futex_wait m_idle;
+    std::atomic<bool> m_stopping {false};
+
+    std::vector<std::jthread> m_threads;
+
+    bool try_pop_injected(task & out)
+    {
+      if(m_injected_size.load(std::memory_order_relaxed) == 0)
+        return false;
+
+      auto lock = std::scoped_lock(m_injection_mutex);
+      if(m_injected.empty())
+        return false;
+      out = std::move(m_injected.front());
+      m_injected.pop_front();
+      m_injected_size.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    bool try_find_task(invocable_impl::worker & self, task & out)
+    {
+      if(self.deque.try_pop(out) || try_pop_injected(out))
+        return true;
+
+      auto const count = m_workers.size();
+      for(std::size_t i = 1; i < count; ++i)
+        if(m_workers[(self.index + i) % count]->deque.try_steal(out))
+          return true;
+      return false;
+    }
+
+    bool has_work() const noexcept
+    {
+      if(m_injected_size.load(std::memory_order_relaxed) != 0)
+        return true;
+      for(auto const & worker : m_workers)
+        if(!worker->deque.empty())
+          return true;
+      return false;
+    }
+
+    void work(invocable_impl::worker & self)
+    {
+      invocable_impl::current_worker = &self;
+
+      auto next = task();
+      for(;;) {
+        if(try_find_task(self, next)) {
+          next();
+          continue;
+        }
+        if(m_stopping.load(std::memory_order_acquire) && !has_work())
+          break;
+        m_idle.wait_until(
+            [this] { return m_stopping.load(std::memory_order_acquire) || has_work(); });
+      }
+
+      invocable_impl::current_worker = nullptr;
+    }
+
+  public:
+    explicit work_stealing_executor(std::size_t threads = std::thread::hardware_concurrency())
+    {
+      threads = std::max<std::size_t>(threads, 1);
+
+      m_workers.reserve(threads);
+      for(std::size_t i = 0; i < threads; ++i)
+        m_workers.push_back(std::unique_ptr<invocable_impl::worker>(new invocable_impl::worker {
+            this, &m_idle, i, invocable_impl::work_stealing_deque(worker_deque_capacity)}));
+
+      m_threads.reserve(threads);
+      for(auto & worker : m_workers)
+        m_threads.emplace_back([this, &worker = *worker] { work(worker); });
+    }
+
+    work_stealing_executor(work_stealing_executor const &) = delete;
+    work_stealing_executor & operator=(work_stealing_executor const &) = delete;
+
+    ~work_stealing_executor()
+    {
+      m_stopping.store(true, std::memory_order_release);
+      m_idle.wake();
+      m_threads.clear();
+    }
+
+    std::size_t size() const noexcept
+    {
+      return m_workers.size();
+    }
+
+    /** Schedules 't'. The pushing worker's own deque is used when called from a worker. */
+    void execute(task t)
+    {
+      auto * self = invocable_impl::current_worker;
+      if(!self || self->executor != this || !self->deque.try_push(t)) {
+        auto lock = std::scoped_lock(m_injection_mutex);
+        m_injected.push_back(std::move(t));
+        m_injected_size.fetch_add(1, std::memory_order_relaxed);
+      }
+      m_idle.notify();
+    }
+
+    /** Schedules 'fn(args...)' without a way to observe its completion.
+     * An exception escaping 'fn' terminates the program.
+     */
+    template<typename F, typename... Args>
+      requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+    void post(F && fn, Args &&... args)
+    {
+      execute(invocable_impl::bound_task<std::decay_t<F>, std::decay_t<Args>...> {
+          std::forward<F>(fn), {std::forward<Args>(args)...}});
+    }
+
+    /** Schedules 'fn(args...)' and returns a future of its deduced return type.
+     * The callable and its arguments are stored inline in the task when they fit, and the state
+     * shared with the future is reused from the per-thread block_cache, so only captures
+     * larger than task_inline_size allocate once the cache is warm.
+     */
+    template<typename F, typename... Args>
+      requires invoke_deducible<std::decay_t<F>> &&
+               std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+    auto submit(F && fn, Args &&... args) -> task_future<invocable_ret_t<std::decay_t<F>>>
+    {
+      using R = invocable_ret_t<std::decay_t<F>>;
+      using state_type = invocable_impl::future_state<R>;
+
+      auto state = std::make_unique<state_type>();
+      execute(invocable_impl::future_task<R, std::decay_t<F>, std::decay_t<Args>...> {
+          state.get(), std::forward<F>(fn), {std::forward<Args>(args)...}});
+      return task_future<R>(state.release());
+    }
+
+    /** Runs pending tasks on the calling worker thread until 'ready()' is true. When there is
+     * nothing to run, sleeps on the idle wait, which is notified by new tasks and by completed
+     * futures.
+     */
+    template<typename Pred>
+    void help_until(Pred ready)
+    {
+      auto * self = invocable_impl::current_worker;
+      auto next = task();
+      while(!ready()) {
+        if(try_find_task(*self, next))
+          next();
+        else
+          m_idle.wait_until([&] { return ready() || has_work(); });
+      }
+    }
+  };
+
+  template<typename R>
+  void task_future<R>::wait() const
+  {
+    if(ready())
+      return;
+
+    if(auto * self = invocable_impl::current_worker) {
+      self->executor->help_until([this] { return ready(); });
+      return;
+    }
+
+    auto status = m_state->status.load(std::memory_order_acquire);
+    while(status == invocable_impl::future_status::pending) {
+      m_state->status.wait(status, std::memory_order_acquire);
+      status = m_state->status.load(std::memory_order_acquire);
+    }
+  }
+
+} // namespace ruby::inv
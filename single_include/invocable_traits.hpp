@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -9,6 +12,66 @@ namespace ruby::inv
 
   // clang-format off
 
+  /**
+   * Define RUBY_INVOCABLE_TRAITS_STAGED_MATCHING to select the staged matching strategy.
+   * By default every function_traits specialization rebuilds its function type through
+   * make_function, and qualifiers are removed one at a time, each step a new partial match.
+   * In the staged strategy the qualifiers of a function type are encoded in a key, and
+   * function types are built by a full specialization of function_builder on that key, which
+   * needs no partial matching; function_traits shares one record of qualifiers per key and does
+   * not rebuild its function type, and the composite modifications, like
+   * function_remove_qualifiers_t, rebuild the function type in a single step.
+   */
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  namespace invocable_impl
+  {
+    constexpr unsigned qualifier_key(bool IsConst, bool IsVolatile, unsigned NumRef, bool IsVariadic)
+    {
+      return unsigned(IsConst) | unsigned(IsVolatile) << 1 | NumRef << 2 | unsigned(IsVariadic) << 4;
+    }
+
+    template<unsigned Key>
+    struct function_builder;
+
+    /** The qualifiers of a function type: one instantiation per combination, shared by every
+     * function_traits lookup.
+     */
+    template<unsigned Key, bool IsNoexcept>
+    struct function_qualifiers
+    {
+      static constexpr bool is_const = Key & 1;
+      static constexpr bool is_volatile = (Key >> 1) & 1;
+      static constexpr unsigned num_references = (Key >> 2) & 3;
+      static constexpr bool is_noexcept = IsNoexcept;
+      static constexpr bool is_variadic = (Key >> 4) & 1;
+    };
+
+    /** The return and argument types of the function type 'T', which is not rebuilt. */
+    template<typename T, typename Ret, typename... Args>
+    struct function_signature
+    {
+      using function_type = T;
+      using return_type = Ret;
+      using argument_types = std::tuple<Args...>;
+
+      static constexpr auto arity = sizeof...(Args);
+
+      template<std::size_t index>
+        requires(index < arity)
+      using argument = std::tuple_element_t<index, argument_types>;
+    };
+  }
+
+  template<
+    bool IsConst, bool IsVolatile, unsigned NumRef,
+    bool IsVariadic,  bool IsNoexcept, typename Ret, typename... Args>
+      requires (NumRef < 3)
+  struct make_function
+  {
+    using type = typename invocable_impl::function_builder<invocable_impl::qualifier_key(
+        IsConst, IsVolatile, NumRef, IsVariadic)>::template type<IsNoexcept, Ret, Args...>;
+  };
+#else
   /**
    * make_function builds a function types with the given qualifiers, return type and argument types.
    * The primarty template is not defined, because all cases are handled by the template specializations.
@@ -18,15 +81,25 @@ namespace ruby::inv
     bool IsVariadic,  bool IsNoexcept, typename Ret, typename... Args>
       requires (NumRef < 3)
   struct make_function;
+#endif
 
   /** Returns a function type with the given qualifiers, return type and argument types.
    */
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  template<
+    bool IsConst, bool IsVolatile,  unsigned NumRef, 
+    bool IsVariadic, bool IsNoexcept, typename Ret, typename... Args>
+      requires (NumRef < 3)
+  using make_function_t = typename invocable_impl::function_builder<invocable_impl::qualifier_key(
+      IsConst, IsVolatile, NumRef, IsVariadic)>::template type<IsNoexcept, Ret, Args...>;
+#else
   template<
     bool IsConst, bool IsVolatile,  unsigned NumRef, 
     bool IsVariadic, bool IsNoexcept, typename Ret, typename... Args>
       requires (NumRef < 3)
   using make_function_t = typename make_function<IsConst, IsVolatile, NumRef, IsVariadic,
                                                  IsNoexcept, Ret, Args...>::type;
+#endif
 
   template<bool IsConst, bool IsVolatile, unsigned NumRef, bool IsVariadic,
            bool IsNoexcept, typename Ret, typename... Args>
@@ -145,15 +218,56 @@ namespace ruby::inv
     struct function_modify<T> : function_modify<T, function_args_t<T>>
     {};
 
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+    /** Every modification rebuilds the function type in one step, from the qualifier key of 'T'
+     * and a full specialization of function_builder.
+     */
     template<typename T, typename... Args>
     struct function_modify<T, std::tuple<Args...>>
     {
   private:
-      static constexpr auto C = function_is_const_v<T>;
-      static constexpr auto V = function_is_volatile_v<T>;
+      using traits = function_traits<T>;
+
+      static constexpr auto key = qualifier_key(traits::is_const, traits::is_volatile,
+                                                traits::num_references, traits::is_variadic);
+      static constexpr auto IN = traits::is_noexcept;
+
+      template<unsigned Key, bool IsNoexcept>
+      using with = typename function_builder<Key>::template type<IsNoexcept,
+                                                                typename traits::return_type, Args...>;
+
+  public:
+      using add_const = with<key | 0b00001u, IN>;
+      using remove_const = with<key & ~0b00001u, IN>;
+
+      using add_volatile = with<key | 0b00010u, IN>;
+      using remove_volatile = with<key & ~0b00010u, IN>;
+
+      using add_variadic = with<key | 0b10000u, IN>;
+      using remove_variadic = with<key & ~0b10000u, IN>;
+
+      using add_noexcept = with<key, true>;
+      using remove_noexcept = with<key, false>;
+
+      using remove_lvalue_reference = with<key & ~0b00100u, IN>;
+      using remove_rvalue_reference = with<key & ~0b01000u, IN>;
+
+      using add_cv = with<key | 0b00011u, IN>;
+      using remove_cv = with<key & ~0b00011u, IN>;
+      using remove_reference = with<key & ~0b01100u, IN>;
+      using remove_cvref = with<key & 0b10000u, IN>;
+      using remove_qualifiers = with<key & 0b10000u, false>;
+    };
+#else
+    template<typename T, typename... Args>
+    struct function_modify<T, std::tuple<Args...>>
+    {
+  private:
+      static constexpr auto C = function_traits<T>::is_const;
+      static constexpr auto V = function_traits<T>::is_volatile;
       static constexpr auto R = function_traits<T>::num_references;
-      static constexpr auto IV = function_is_variadic_v<T>;
-      static constexpr auto IN = function_is_noexcept_v<T>;
+      static constexpr auto IV = function_traits<T>::is_variadic;
+      static constexpr auto IN = function_traits<T>::is_noexcept;
       using ret = function_ret_t<T>;
 
   public:
@@ -172,6 +286,7 @@ namespace ruby::inv
       using remove_lvalue_reference = make_function_t<C, V, R & 0b10, IV, IN, ret, Args...>;
       using remove_rvalue_reference = make_function_t<C, V, R & 0b01, IV, IN, ret, Args...>;
     };
+#endif
   } // namespace impl
 
   // clang-format off
@@ -194,11 +309,19 @@ namespace ruby::inv
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_add_cv_t = typename invocable_impl::function_modify<T>::add_cv;
+#else
   using function_add_cv_t = function_add_const_t<function_add_volatile_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_cv_t = typename invocable_impl::function_modify<T>::remove_cv;
+#else
   using function_remove_cv_t = function_remove_const_t<function_remove_volatile_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
@@ -228,19 +351,70 @@ namespace ruby::inv
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_reference_t = typename invocable_impl::function_modify<T>::remove_reference;
+#else
   using function_remove_reference_t =
       function_remove_lvalue_reference_t<function_remove_rvalue_reference_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_cvref_t = typename invocable_impl::function_modify<T>::remove_cvref;
+#else
   using function_remove_cvref_t = function_remove_cv_t<function_remove_reference_t<T>>;
+#endif
 
   template<typename T>
     requires std::is_function_v<T>
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+  using function_remove_qualifiers_t = typename invocable_impl::function_modify<T>::remove_qualifiers;
+#else
   using function_remove_qualifiers_t = function_remove_cvref_t<function_remove_noexcept_t<T>>;
+#endif
 
   // clang-format on
 
+
+  /** Compact description of one function argument type, see function_arg_properties_v. */
+  struct arg_properties
+  {
+    std::uint32_t size;      // sizeof the referred object type, 0 if it is not an object type
+    std::uint16_t alignment; // alignof the referred object type, 0 if it is not an object type
+    bool is_reference : 1;
+    bool is_rvalue_reference : 1;
+    bool is_pointer : 1;
+    bool is_trivially_copyable : 1;
+    bool is_trivially_destructible : 1;
+
+    template<typename T>
+    static constexpr arg_properties of() noexcept
+    {
+      using U = std::remove_reference_t<T>;
+      auto properties = arg_properties{0, 0, std::is_reference_v<T>, std::is_rvalue_reference_v<T>,
+                                       std::is_pointer_v<U>, false, false};
+      if constexpr(std::is_object_v<U>){
+        static_assert(sizeof(U) <= std::numeric_limits<std::uint32_t>::max(),
+                      "the argument type is too large for arg_properties::size");
+        static_assert(alignof(U) <= std::numeric_limits<std::uint16_t>::max(),
+                      "the argument type is too aligned for arg_properties::alignment");
+        properties.size = sizeof(U);
+        properties.alignment = alignof(U);
+        properties.is_trivially_copyable = std::is_trivially_copyable_v<U>;
+        properties.is_trivially_destructible = std::is_trivially_destructible_v<U>;
+      }
+      return properties;
+    }
+  };
+
+  /** One arg_properties record per argument of the function type 'T', in order. */
+  template<typename T>
+    requires std::is_function_v<T>
+  inline constexpr auto function_arg_properties_v = []<typename... Args>(std::tuple<Args...> *) {
+    return std::array<arg_properties, sizeof...(Args)>{arg_properties::of<Args>()...};
+  }(static_cast<function_args_t<T> *>(nullptr));
+
 #define RUBY_ADD_CVREF_000
 #define RUBY_ADD_CVREF_010 volatile
 #define RUBY_ADD_CVREF_100 const
@@ -262,6 +436,25 @@ namespace ruby::inv
 #define RUBY_MAYBE_CVREF(X, Y, Z) RUBY_CONCAT4(RUBY_ADD_CVREF_, X, Y, Z)
 #define RUBY_MAYBE_VARIADIC(X) RUBY_CONCAT2(RUBY_VARIADIC_, X)
 
+#ifdef RUBY_INVOCABLE_TRAITS_STAGED_MATCHING
+
+#define RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, Qual, Pack)                      \
+  template<>                                                                         \
+  struct invocable_impl::function_builder<invocable_impl::qualifier_key(C, V, R, IV)> \
+  {                                                                                  \
+    template<bool IN, typename Ret, typename... Args>                                \
+    using type = Ret(Args... Pack) Qual noexcept(IN);                                \
+  };
+
+#define RUBY_DEFINE_FUNCTION_TRAITS_IMPL(C, V, R, IV, Qual, Pack)                          \
+  template<bool IN, typename Ret, typename... Args>                                        \
+  struct function_traits<Ret(Args... Pack) Qual noexcept(IN)>                              \
+    : invocable_impl::function_qualifiers<invocable_impl::qualifier_key(C, V, R, IV), IN>  \
+    , invocable_impl::function_signature<Ret(Args... Pack) Qual noexcept(IN), Ret, Args...> \
+  {};
+
+#else
+
 #define RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, Qual, Pack) \
   template<bool IN, typename Ret, typename... Args>        \
   struct make_function<C, V, R, IV, IN, Ret, Args...>      \
@@ -269,15 +462,17 @@ namespace ruby::inv
     using type = Ret(Args... Pack) Qual noexcept(IN);      \
   };
 
-#define RUBY_DEFINE_MAKE_FUNCTION(C, V, R, IV) \
-  RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, RUBY_MAYBE_CVREF(C, V, R), RUBY_MAYBE_VARIADIC(IV))
-
 #define RUBY_DEFINE_FUNCTION_TRAITS_IMPL(C, V, R, IV, Qual, Pack)  \
   template<bool IN, typename Ret, typename... Args>           \
   struct function_traits<Ret(Args... Pack) Qual noexcept(IN)> \
     : function_types<C, V, R, IV, IN, Ret, Args...>           \
   {};
 
+#endif
+
+#define RUBY_DEFINE_MAKE_FUNCTION(C, V, R, IV) \
+  RUBY_DEFINE_MAKE_FUNCTION_IMPL(C, V, R, IV, RUBY_MAYBE_CVREF(C, V, R), RUBY_MAYBE_VARIADIC(IV))
+
 #define RUBY_DEFINE_FUNCTION_TRAITS(C, V, R, IV) \
   RUBY_DEFINE_FUNCTION_TRAITS_IMPL(C, V, R, IV, RUBY_MAYBE_CVREF(C, V, R), RUBY_MAYBE_VARIADIC(IV))
 
@@ -499,6 +694,22 @@ namespace ruby::inv
   template<invoke_deducible T, std::size_t index>
   using invocable_arg_t = function_arg_t<invocable_function_t<T>, index>;
 
+  template<invoke_deducible T>
+  using invocable_signature_t = function_remove_qualifiers_t<invocable_function_t<T>>;
+
+  namespace invocable_impl{
+    template<typename Tuple>
+    struct decay_tuple;
+
+    template<typename... Args>
+    struct decay_tuple<std::tuple<Args...>>{
+      using type = std::tuple<std::decay_t<Args>...>;
+    };
+  }
+
+  template<invoke_deducible T>
+  using invocable_decayed_args_t = typename invocable_impl::decay_tuple<invocable_args_t<T>>::type;
+
   namespace invocable_impl{
     struct ARGUMENT_TYPE_IS_NOT_DEDUCIBLE{
     };
@@ -539,4 +750,280 @@ namespace ruby::inv
   template<typename T>
   inline constexpr auto invocable_is_reference_v =
       function_is_reference_v<invocable_impl::maybe_function_t<T>>;
+
+  template<typename T>
+  inline constexpr auto invocable_arg_properties_v =
+      function_arg_properties_v<invocable_impl::maybe_function_t<T>>;
+
+  // clang-format off
+
+  namespace invocable_impl{
+    /** 'Ptr' names a call operator that a call with 'F' and 'Args' can use. */
+    template<typename Ptr, typename F, typename... Args>
+    concept call_operator_for =
+      std::is_member_function_pointer_v<Ptr> &&
+      std::is_invocable_v<Ptr, F, Args...> &&
+      std::same_as<std::invoke_result_t<Ptr, F, Args...>, std::invoke_result_t<F, Args...>>;
+
+    /** Types an arithmetic argument is also probed as, for calls that convert it. */
+    using probe_conversion_types = std::tuple<bool, char, signed char, unsigned char, short,
+                                              unsigned short, int, unsigned, long, unsigned long,
+                                              long long, unsigned long long, float, double,
+                                              long double>;
+
+    /** Parameter type forms probed, in order: decayed, forwarded (Arg&&) and const reference,
+     * then the same three with every arithmetic argument taken as one of
+     * probe_conversion_types, by value or by const reference.
+     */
+    inline constexpr unsigned probe_form_count =
+      3 * (1 + 2 * std::tuple_size_v<probe_conversion_types>);
+
+    template<unsigned Form, typename Arg>
+    consteval auto probe_arg(){
+      using A = std::remove_cvref_t<Arg>;
+      constexpr auto conversion = Form / 3;
+      if constexpr(conversion != 0 && std::is_arithmetic_v<A>){
+        using X = std::tuple_element_t<(conversion - 1) / 2, probe_conversion_types>;
+        if constexpr((conversion - 1) % 2 == 0)
+          return std::type_identity<X>{};
+        else
+          return std::type_identity<X const&>{};
+      } else if constexpr(Form % 3 == 0){
+        return std::type_identity<A>{};
+      } else if constexpr(Form % 3 == 1){
+        return std::type_identity<Arg&&>{};
+      } else {
+        return std::type_identity<A const&>{};
+      }
+    }
+
+    template<unsigned Form, typename Arg>
+    using probe_arg_t = typename decltype(probe_arg<Form, Arg>())::type;
+
+    /** A conversion form gives the same types as an earlier form when no argument is
+     * arithmetic, or when every argument is and the form is not the decayed one.
+     */
+    template<unsigned Form, typename... Args>
+    inline constexpr bool is_redundant_form_v =
+      Form / 3 != 0 &&
+      (!(std::is_arithmetic_v<std::remove_cvref_t<Args>> || ...) ||
+       (Form % 3 != 0 && (std::is_arithmetic_v<std::remove_cvref_t<Args>> && ...)));
+
+    template<typename T, typename Fn>
+    concept has_call_operator_of_type = requires{
+      static_cast<Fn T::*>(&T::operator());
+    };
+
+    /** Returned by the operator() a call_operator_probe declares. */
+    struct selected_call_operator{};
+
+    /** Derives from 'T' and replaces its operator() taking 'P' with the qualifiers 'Key' (const
+     * in the low bit, then no reference, & or &&) by one returning selected_call_operator. The
+     * other overloads stay visible, so a call selects the replacement exactly when overload
+     * resolution on 'T' selects the replaced operator.
+     */
+    template<typename T, unsigned Key, typename... P>
+    struct call_operator_probe;
+
+#define RUBY_DEFINE_CALL_OPERATOR_PROBE(Key, Qual)                 \
+  template<typename T, typename... P>                              \
+  struct call_operator_probe<T, Key, P...> : T                     \
+  {                                                                \
+    using T::operator();                                           \
+    selected_call_operator operator()(P...) Qual;                  \
+  };
+
+    RUBY_DEFINE_CALL_OPERATOR_PROBE(0, )
+    RUBY_DEFINE_CALL_OPERATOR_PROBE(1, const)
+    RUBY_DEFINE_CALL_OPERATOR_PROBE(2, &)
+    RUBY_DEFINE_CALL_OPERATOR_PROBE(3, const&)
+    RUBY_DEFINE_CALL_OPERATOR_PROBE(4, &&)
+    RUBY_DEFINE_CALL_OPERATOR_PROBE(5, const&&)
+
+#undef RUBY_DEFINE_CALL_OPERATOR_PROBE
+
+    template<typename F, typename T>
+    using copy_cv_t =
+      std::conditional_t<std::is_const_v<F>,
+                         std::conditional_t<std::is_volatile_v<F>, T const volatile, T const>,
+                         std::conditional_t<std::is_volatile_v<F>, T volatile, T>>;
+
+    /** 'T' with the cv-qualifiers and value category of 'F', a prvalue being an rvalue. */
+    template<typename F, typename T>
+    using copy_cvref_t =
+      std::conditional_t<std::is_lvalue_reference_v<F>,
+                         copy_cv_t<std::remove_reference_t<F>, T>&,
+                         copy_cv_t<std::remove_reference_t<F>, T>&&>;
+
+    /** A call with 'F' and 'Args' selects the operator() 'Probe' replaced. */
+    template<typename F, typename Probe, typename... Args>
+    concept selects_probed_operator = std::same_as<
+      std::invoke_result_t<copy_cvref_t<F, Probe>, Args...>, selected_call_operator>;
+
+    /** Looks for the operator() of type 'R(probe_arg_t<Form, Args>...) Q', for every
+     * const, reference and noexcept qualifier list Q, noexcept ones first; volatile ones are
+     * not probed. Templated operators deduce their template arguments from that type.
+     * An operator found is only kept if a call with 'F' and 'Args' selects it.
+     */
+    template<typename F, unsigned Form, unsigned Q, typename... Args>
+    consteval auto probe_qualified_call_operator(){
+      using T = std::remove_cvref_t<F>;
+      if constexpr(Q == 12){
+        return std::type_identity<void>{};
+      } else {
+        constexpr bool is_const = Q % 2 == 0;
+        constexpr unsigned ref = (Q / 2) % 3;
+        using Fn = make_function_t<is_const, false, ref, false, Q < 6,
+                                   std::invoke_result_t<F, Args...>, probe_arg_t<Form, Args>...>;
+        using probe = call_operator_probe<T, ref * 2 + is_const, probe_arg_t<Form, Args>...>;
+        if constexpr(has_call_operator_of_type<T, Fn>){
+          if constexpr(call_operator_for<Fn T::*, F, Args...> &&
+                       selects_probed_operator<F, probe, Args...>)
+            return std::type_identity<Fn T::*>{};
+          else
+            return probe_qualified_call_operator<F, Form, Q + 1, Args...>();
+        } else {
+          return probe_qualified_call_operator<F, Form, Q + 1, Args...>();
+        }
+      }
+    }
+
+    template<typename F, unsigned Form, typename... Args>
+    consteval auto probe_call_operator(){
+      if constexpr(Form == probe_form_count){
+        return std::type_identity<void>{};
+      } else if constexpr(is_redundant_form_v<Form, Args...>){
+        return probe_call_operator<F, Form + 1, Args...>();
+      } else {
+        using found = typename decltype(probe_qualified_call_operator<F, Form, 0, Args...>())::type;
+        if constexpr(!std::is_void_v<found>)
+          return std::type_identity<found>{};
+        else
+          return probe_call_operator<F, Form + 1, Args...>();
+      }
+    }
+
+    /** The type whose invocable_traits describe a call with 'F' and 'Args', or void. Final
+     * classes cannot be derived from to check which operator a call selects, so only those
+     * with a single call operator resolve.
+     */
+    template<typename F, typename... Args>
+    consteval auto resolve_call(){
+      using T = std::remove_cvref_t<F>;
+      if constexpr(!std::is_invocable_v<F, Args...>)
+        return std::type_identity<void>{};
+      else if constexpr(ruby::inv::invoke_deducible<T>)
+        return std::type_identity<T>{};
+      else if constexpr(!std::is_class_v<T> || std::is_final_v<T>)
+        return std::type_identity<void>{};
+      else
+        return probe_call_operator<F, 0, Args...>();
+    }
+
+    template<typename F, typename... Args>
+    using resolved_call_t = typename decltype(resolve_call<F, Args...>())::type;
+  }
+
+  /** A call with 'F' and 'Args' resolves to one function type, even when 'F' is a generic
+   * lambda or has overloaded or templated call operators.
+   */
+  template<typename F, typename... Args>
+  concept invoke_deducible_for = !std::is_void_v<invocable_impl::resolved_call_t<F, Args...>>;
+
+  /**
+   * invocable_traits of the function that a call with 'F' and 'Args' selects. When 'F' has no
+   * single call operator, the operator() types returning the invoke result are probed with the
+   * decayed, forwarded (Args&&) and const reference argument types, then with arithmetic
+   * arguments converted to each arithmetic type, with every qualifier list but the volatile
+   * ones; templated operators deduce their arguments from the probed type. An operator found
+   * is kept only if overload resolution for the call, with the value category and constness
+   * of 'F', selects it; a call selecting an operator whose parameters none of the probed
+   * types match is not deducible.
+   * Each resolution is a class template specialization, so the compiler performs it once per
+   * translation unit however often it is queried.
+   */
+  template<typename F, typename... Args>
+  struct invocable_traits_for
+  {};
+
+  template<typename F, typename... Args>
+    requires invoke_deducible_for<F, Args...>
+  struct invocable_traits_for<F, Args...> : invocable_traits<invocable_impl::resolved_call_t<F, Args...>>
+  {};
+
+  template<typename F, typename... Args>
+    requires invoke_deducible_for<F, Args...>
+  using invocable_function_for_t = typename invocable_traits_for<F, Args...>::function_type;
+
+  // clang-format on
+
+  // clang-format off
+
+  namespace invocable_impl{
+    template<typename From, typename To>
+    inline constexpr bool convertible_signature_v = false;
+
+    /** Every argument of 'From' converts to the matching parameter of 'To', and the result of
+     * 'To' converts to the result of 'From' (or 'From' returns void).
+     */
+    template<typename R1, typename... Args1, typename R2, typename... Args2>
+      requires (sizeof...(Args1) == sizeof...(Args2))
+    inline constexpr bool convertible_signature_v<R1(Args1...), R2(Args2...)> =
+      (std::is_void_v<R1> || std::is_convertible_v<R2, R1>) &&
+      (std::is_convertible_v<Args1, Args2> && ...);
+
+    template<typename F, typename Args>
+    inline constexpr bool const_invocable_with_v = false;
+
+    template<typename F, typename... Args>
+    inline constexpr bool const_invocable_with_v<F, std::tuple<Args...>> =
+      std::is_invocable_v<F, Args...>;
+
+    /** 'F' honours the qualifiers of 'Sig': when 'Sig' is const, the deduced call operator of
+     * 'F' is const and 'F' is invocable through a const object with the value category of the
+     * reference qualifier of 'Sig'; when 'Sig' is noexcept, so is 'F'.
+     * The deduced operator is checked because a captureless lambda with a mutable operator is
+     * still invocable through const, by converting to a function pointer.
+     */
+    template<typename F, typename Sig>
+    inline constexpr bool qualifier_compatible_v =
+      (!function_is_const_v<Sig> ||
+       ((!std::is_class_v<F> || invocable_is_const_v<F>) &&
+        const_invocable_with_v<std::conditional_t<function_is_rvalue_reference_v<Sig>,
+                                                  F const&&, F const&>,
+                               function_args_t<Sig>>)) &&
+      (!function_is_noexcept_v<Sig> || invocable_is_noexcept_v<F>);
+  }
+
+  /** The function type of 'F' is exactly 'Sig', qualifiers and noexcept included. */
+  template<typename F, typename Sig>
+  concept invocable_exactly =
+    invoke_deducible<F> &&
+    std::is_function_v<Sig> &&
+    std::same_as<invocable_function_t<F>, Sig>;
+
+  /** The function type of 'F' is 'Sig' once qualifiers and noexcept are removed from both. */
+  template<typename F, typename Sig>
+  concept invocable_as =
+    invoke_deducible<F> &&
+    std::is_function_v<Sig> &&
+    std::same_as<invocable_signature_t<F>, function_remove_qualifiers_t<Sig>>;
+
+  /**
+   * 'F' can stand for a callable of signature 'Sig': same arity, every argument type of 'Sig'
+   * converts to the parameter of 'F', and the result of 'F' converts to the result of 'Sig'
+   * unless that is void. Only conversions are checked, there is no overload resolution, so
+   * this is cheaper to evaluate than std::is_invocable_r but requires a deducible 'F'.
+   * A const 'Sig' requires 'F' to be invocable as const, and a noexcept one requires 'F' to be
+   * noexcept.
+   */
+  template<typename F, typename Sig>
+  concept invocable_compatible =
+    invoke_deducible<F> &&
+    std::is_function_v<Sig> &&
+    !invocable_is_variadic_v<F> &&
+    invocable_impl::convertible_signature_v<function_remove_qualifiers_t<Sig>, invocable_signature_t<F>> &&
+    invocable_impl::qualifier_compatible_v<F, Sig>;
+
+  // clang-format on
 } // namespace ruby::invocable
@@ -0,0 +1,125 @@
+
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+#include <ruby/invocable_traits/apply_from.hpp>
+
+#include "../check.hpp"
+
+namespace apply_from_tests
+{
+  using namespace ruby::inv;
+
+  using value = std::variant<long, double, std::string>;
+
+  struct point
+  {
+    double x;
+    double y;
+  };
+
+  struct counted
+  {
+    int calls = 0;
+
+    int operator()(long n) &
+    {
+      calls += 1;
+      return static_cast<int>(n) + calls;
+    }
+  };
+
+  inline long add(long a, long b)
+  {
+    return a + b;
+  }
+
+  inline void variadic(int, ...) {}
+
+  template<typename F, typename Value>
+  concept CanApply = applicable_from<F, Value>;
+
+  inline void test_concept()
+  {
+    auto strings = [](std::string const &, std::string) {};
+    auto mutable_ref = [](std::string &) {};
+
+    static_assert(CanApply<decltype(strings), value>);
+    static_assert(CanApply<decltype(&add), value>);
+    static_assert(CanApply<decltype(add), int>);
+    static_assert(!CanApply<decltype(mutable_ref), value>);
+    static_assert(!CanApply<decltype(variadic), int>);
+    static_assert(!CanApply<decltype(&point::x), value>);
+    static_assert(!CanApply<decltype(strings), int>);
+  }
+
+  inline void test_apply_variant()
+  {
+    auto const values = std::vector<value> {3L, 2.5, std::string("abc")};
+
+    auto describe = [](long n, double d, std::string const & s) {
+      return s + ":" + std::to_string(n) + ":" + std::to_string(static_cast<int>(d * 2));
+    };
+    RUBY_CHECK(apply_from(describe, values) == "abc:3:5");
+    RUBY_CHECK(apply_from(describe, std::span<value const>(values)) == "abc:3:5");
+
+    auto const longs = std::vector<value> {3L, 4L, 5L};
+    RUBY_CHECK(apply_from_buffer(&add, longs.data()) == 7L);
+
+    // The variant itself is passed through by reference.
+    auto identity = [](value const & v) { return &v; };
+    RUBY_CHECK(apply_from(identity, std::span<value const>(values.data(), 1)) == &values[0]);
+
+    // Stateful callables are invoked with their value category.
+    auto callable = counted {};
+    RUBY_CHECK(apply_from(callable, std::span<value const>(values.data(), 1)) == 4);
+    RUBY_CHECK(apply_from(callable, std::span<value const>(values.data(), 1)) == 5);
+    RUBY_CHECK(callable.calls == 2);
+  }
+
+  inline void test_arity_mismatch()
+  {
+    auto const values = std::vector<value> {1L, 2L, 3L};
+
+    bool thrown = false;
+    try {
+      apply_from(add, values);
+    } catch(arity_mismatch const & error) {
+      thrown = true;
+      RUBY_CHECK(error.expected() == 2);
+      RUBY_CHECK(error.actual() == 3);
+    }
+    RUBY_CHECK(thrown);
+
+    thrown = false;
+    try {
+      apply_from([](std::string const &) {}, std::span<value const>(values.data(), 1));
+    } catch(std::bad_variant_access const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+  }
+
+  inline void test_apply_converted()
+  {
+    auto const values = std::vector<int> {4, 5};
+    auto make = [](double x, double y) { return point {x, y}; };
+    auto const p = apply_from(make, values);
+    RUBY_CHECK(p.x == 4.0 && p.y == 5.0);
+
+    int calls = 0;
+    auto nullary = [&calls] { ++calls; };
+    apply_from(nullary, std::span<int const>());
+    RUBY_CHECK(calls == 1);
+  }
+
+  inline void run()
+  {
+    test_concept();
+    test_apply_variant();
+    test_arity_mismatch();
+    test_apply_converted();
+  }
+
+} // namespace apply_from_tests
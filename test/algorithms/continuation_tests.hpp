@@ -0,0 +1,98 @@
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ruby/invocable_traits/continuation.hpp>
+#include <ruby/invocable_traits/work_stealing_executor.hpp>
+
+#include "../check.hpp"
+
+namespace continuation_tests
+{
+  using namespace ruby::inv;
+
+  inline int parse(std::string const & text)
+  {
+    return std::stoi(text);
+  }
+
+  template<typename C, typename G>
+  concept CanThen = requires(C chain, G next)
+  {
+    std::move(chain).then(next);
+  };
+
+  inline void test_types()
+  {
+    auto twice = [](int x) { return 2 * x; };
+    auto chain = start(&parse).then(twice).then([](int x) { return std::to_string(x); });
+
+    static_assert(decltype(chain)::stage_count == 3);
+    static_assert(invoke_deducible<decltype(chain)>);
+    static_assert(
+        std::same_as<invocable_function_t<decltype(chain)>, std::string(std::string const &)>);
+
+    // Every stage is checked against the result of the previous one.
+    using parsed = decltype(start(&parse));
+    static_assert(CanThen<parsed, decltype(twice)>);
+    static_assert(CanThen<parsed, void (*)(long)>);
+    static_assert(!CanThen<parsed, void (*)(std::string)>);
+    static_assert(!CanThen<parsed, void (*)(int, int)>);
+    static_assert(!CanThen<parsed, void (*)()>);
+    static_assert(!CanThen<parsed, decltype([](auto x) { return x; })>);
+
+    RUBY_CHECK(chain("21") == "42");
+    RUBY_CHECK(chain("-4") == "-8");
+  }
+
+  inline void test_moves_results()
+  {
+    auto log = std::vector<std::string>();
+    auto chain = start([](int size) { return std::make_unique<std::vector<int>>(size, 1); })
+                     .then([](std::unique_ptr<std::vector<int>> values) {
+                       values->push_back(5);
+                       return values;
+                     })
+                     .then([&log](std::unique_ptr<std::vector<int>> values) {
+                       log.push_back("sum");
+                       int sum = 0;
+                       for(auto v : *values)
+                         sum += v;
+                       return sum;
+                     })
+                     .then([&log](int sum) { log.push_back(std::to_string(sum)); })
+                     .then([&log] {
+                       log.push_back("done");
+                       return log.size();
+                     });
+
+    RUBY_CHECK(chain(3) == 3);
+    RUBY_CHECK((log == std::vector<std::string> {"sum", "8", "done"}));
+
+    // Extending an lvalue chain copies it.
+    auto longer = chain.then([](std::size_t n) { return n * 10; });
+    RUBY_CHECK(longer(0) == 60);
+    RUBY_CHECK(chain(1) == 9);
+  }
+
+  inline void test_submit()
+  {
+    auto executor = work_stealing_executor(2);
+    auto chain = start([](std::string a, std::string b) { return a + b; })
+                     .then([](std::string s) { return s.size(); })
+                     .then([](std::size_t n) { return n * n; });
+
+    auto future = executor.submit(std::move(chain), "abc", "de");
+    static_assert(std::same_as<decltype(future), task_future<std::size_t>>);
+    RUBY_CHECK(future.get() == 25);
+  }
+
+  inline void run()
+  {
+    test_types();
+    test_moves_results();
+    test_submit();
+  }
+
+} // namespace continuation_tests
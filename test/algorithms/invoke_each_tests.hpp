@@ -0,0 +1,133 @@
+
+#include <atomic>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include <ruby/invocable_traits/invoke_each.hpp>
+
+#include "../check.hpp"
+
+namespace invoke_each_tests
+{
+  using namespace ruby::inv;
+
+  struct Entity
+  {
+    int position = 0;
+    int updates = 0;
+
+    void update(int velocity)
+    {
+      position += velocity;
+      ++updates;
+    }
+
+    int get() const
+    {
+      return position;
+    }
+  };
+
+  struct Derived : Entity
+  {};
+
+  struct Counter
+  {
+    void count(std::atomic<int> & total) const
+    {
+      total.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  inline void test_member_function_of()
+  {
+    static_assert(member_function_of<decltype(&Entity::update), Entity, int>);
+    static_assert(member_function_of<decltype(&Entity::update), Derived, int>);
+    static_assert(member_function_of<decltype(&Entity::get), Entity const>);
+    static_assert(!member_function_of<decltype(&Entity::update), Entity const, int>);
+    static_assert(!member_function_of<decltype(&Entity::update), Counter, int>);
+    static_assert(!member_function_of<decltype(&Entity::update), Entity>);
+  }
+
+  inline void test_invoke_each()
+  {
+    auto entities = std::vector<Entity>(100);
+    invoke_each(std::span(entities), &Entity::update, 3);
+    invoke_each<&Entity::update>(std::span(entities), 2);
+
+    for(auto const & entity : entities) {
+      RUBY_CHECK(entity.position == 5);
+      RUBY_CHECK(entity.updates == 2);
+    }
+
+    auto derived = std::vector<Derived>(3);
+    invoke_each(std::span(derived), &Entity::update, 1);
+    RUBY_CHECK(derived[2].position == 1);
+
+    auto empty = std::vector<Entity>();
+    invoke_each(std::span(empty), &Entity::update, 1);
+  }
+
+  inline void test_invoke_each_parallel()
+  {
+    auto entities = std::vector<Entity>(1001);
+    invoke_each_parallel(4, std::span(entities), &Entity::update, 7);
+    invoke_each_parallel<&Entity::update>(16, std::span(entities), 1);
+
+    for(auto const & entity : entities)
+      RUBY_CHECK(entity.position == 8 && entity.updates == 2);
+
+    auto counters = std::vector<Counter>(10);
+    auto total = std::atomic<int>(0);
+    invoke_each_parallel(64, std::span<Counter const>(counters), &Counter::count, total);
+    RUBY_CHECK(total == 10);
+  }
+
+  struct Fragile
+  {
+    int id = 0;
+    bool visited = false;
+
+    void visit(int broken)
+    {
+      if(id == broken)
+        throw std::runtime_error("broken");
+      visited = true;
+    }
+  };
+
+  inline void test_invoke_each_parallel_exception()
+  {
+    auto objects = std::vector<Fragile>(1000);
+    for(int i = 0; i < 1000; ++i)
+      objects[i].id = i;
+
+    // Thrown by a worker thread, and rethrown by the calling thread.
+    bool thrown = false;
+    try {
+      invoke_each_parallel(4, std::span(objects), &Fragile::visit, 700);
+    } catch(std::runtime_error const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+    RUBY_CHECK(objects[699].visited);
+    RUBY_CHECK(!objects[700].visited && !objects[701].visited);
+
+    thrown = false;
+    try {
+      invoke_each_parallel<&Fragile::visit>(4, std::span(objects), 0);
+    } catch(std::runtime_error const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+  }
+
+  inline void run()
+  {
+    test_member_function_of();
+    test_invoke_each();
+    test_invoke_each_parallel();
+    test_invoke_each_parallel_exception();
+  }
+
+} // namespace invoke_each_tests
@@ -0,0 +1,123 @@
+
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <ruby/invocable_traits/par_transform.hpp>
+
+#include "../check.hpp"
+
+namespace par_transform_tests
+{
+  using namespace ruby::inv;
+
+  /** Not default constructible, and counts its live instances. */
+  struct tracked
+  {
+    static inline std::atomic<int> live = 0;
+
+    long value;
+
+    explicit tracked(long v)
+      : value(v)
+    {
+      ++live;
+    }
+
+    tracked(tracked const & other)
+      : value(other.value)
+    {
+      ++live;
+    }
+
+    ~tracked()
+    {
+      --live;
+    }
+  };
+
+  inline long square(int x)
+  {
+    return long(x) * x;
+  }
+
+  inline void test_parallel()
+  {
+    auto input = std::vector<int>(100'000);
+    std::iota(input.begin(), input.end(), 0);
+
+    auto output = par_transform(input, &square, 4);
+    static_assert(std::same_as<decltype(output), transform_result<long>>);
+    RUBY_CHECK(output.size() == input.size());
+    RUBY_CHECK(reinterpret_cast<std::uintptr_t>(output.data()) % cache_line_size == 0);
+    for(std::size_t i = 0; i < input.size(); ++i)
+      RUBY_CHECK(output[i] == square(input[i]));
+
+    // Results are constructed in place from the declared return type.
+    auto objects = par_transform(input, [](int x) { return tracked(x + 1); }, 3,
+                                 transform_execution::parallel);
+    RUBY_CHECK(tracked::live == 100'000);
+    RUBY_CHECK(objects[99'999].value == 100'000);
+    objects = {};
+    RUBY_CHECK(tracked::live == 0);
+  }
+
+  inline void test_sequential()
+  {
+    static_assert(invocable_impl::is_shareable_callable_v<decltype(&square)>);
+
+    // A mutable callable is never shared between threads unless requested, so it sees the
+    // elements in order.
+    auto input = std::vector<std::string>(50'000, "ab");
+    auto calls = 0;
+    auto counting = [calls](std::string const & s) mutable { return s.size() + calls++; };
+    static_assert(!invocable_impl::is_shareable_callable_v<decltype(counting)>);
+
+    auto output = par_transform(input, counting, 8);
+    RUBY_CHECK(output.size() == input.size());
+    for(std::size_t i = 0; i < output.size(); ++i)
+      RUBY_CHECK(output[i] == i + 2);
+
+    auto small = std::vector<int> {1, 2, 3};
+    auto squares = par_transform(small, &square, 8);
+    RUBY_CHECK((std::vector<long>(squares.begin(), squares.end()) == std::vector<long> {1, 4, 9}));
+
+    auto none = par_transform(std::vector<int>(), &square, 4, transform_execution::parallel);
+    RUBY_CHECK(none.empty());
+    RUBY_CHECK(none.begin() == none.end());
+  }
+
+  inline void test_exception()
+  {
+    auto input = std::vector<int>(60'000);
+    std::iota(input.begin(), input.end(), 0);
+
+    for(auto execution : {transform_execution::sequential, transform_execution::parallel}) {
+      bool caught = false;
+      try {
+        par_transform(
+            input,
+            [](int x) {
+              if(x == 40'000)
+                throw std::runtime_error("bad element");
+              return tracked(x);
+            },
+            4, execution);
+      } catch(std::runtime_error const &) {
+        caught = true;
+      }
+      RUBY_CHECK(caught);
+      RUBY_CHECK(tracked::live == 0);
+    }
+  }
+
+  inline void run()
+  {
+    test_parallel();
+    test_sequential();
+    test_exception();
+  }
+
+} // namespace par_transform_tests
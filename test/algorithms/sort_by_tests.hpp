@@ -0,0 +1,126 @@
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <ruby/invocable_traits/sort_by.hpp>
+
+#include "../check.hpp"
+
+namespace sort_by_tests
+{
+  using namespace ruby::inv;
+
+  enum class Color : std::int8_t
+  {
+    red = -1,
+    green = 0,
+    blue = 1
+  };
+
+  struct Record
+  {
+    int id;
+    std::int64_t key;
+    double weight;
+    Color color;
+    std::string name;
+  };
+
+  inline auto make_records(std::size_t count)
+  {
+    auto records = std::vector<Record>();
+    std::uint64_t state = 12345;
+    for(std::size_t i = 0; i < count; ++i) {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      auto const bits = static_cast<std::int64_t>(state >> 40) - (std::int64_t(1) << 23);
+      records.push_back({static_cast<int>(i),
+                         bits % 97,
+                         static_cast<double>(bits) / 7.0,
+                         static_cast<Color>(bits % 2),
+                         std::to_string(bits)});
+    }
+    return records;
+  }
+
+  inline void test_sortable_by_member()
+  {
+    static_assert(sortable_by_member<std::vector<Record> &, decltype(&Record::key)>);
+    static_assert(!sortable_by_member<std::vector<int> &, decltype(&Record::key)>);
+    static_assert(invocable_impl::is_radix_sortable_v<Color>);
+    static_assert(invocable_impl::is_radix_sortable_v<bool>);
+    static_assert(!invocable_impl::is_radix_sortable_v<std::string>);
+  }
+
+  inline void test_radix_key_order()
+  {
+    using invocable_impl::to_radix_key;
+
+    RUBY_CHECK(to_radix_key(-1) < to_radix_key(0));
+    RUBY_CHECK(to_radix_key(std::numeric_limits<int>::min()) < to_radix_key(-1));
+    RUBY_CHECK(to_radix_key(-2.5) < to_radix_key(-1.0));
+    RUBY_CHECK(to_radix_key(-1.0f) < to_radix_key(0.5f));
+    RUBY_CHECK(to_radix_key(-0.0) == to_radix_key(0.0));
+    RUBY_CHECK(to_radix_key(Color::red) < to_radix_key(Color::blue));
+  }
+
+  template<typename M>
+  inline void check_stable_sort(std::size_t count, M member)
+  {
+    auto records = make_records(count);
+    auto expected = records;
+
+    stable_sort_by(records, member);
+    std::ranges::stable_sort(expected, std::ranges::less {}, member);
+
+    RUBY_CHECK(std::ranges::equal(records, expected, {}, &Record::id, &Record::id));
+  }
+
+  inline void test_stable_sort_by()
+  {
+    for(auto count : {0, 10, 1000, 5000}) {
+      check_stable_sort(count, &Record::id);
+      check_stable_sort(count, &Record::key);
+      check_stable_sort(count, &Record::weight);
+      check_stable_sort(count, &Record::color);
+      check_stable_sort(count, &Record::name);
+    }
+  }
+
+  inline void test_sort_by()
+  {
+    auto records = make_records(5000);
+    sort_by(records, &Record::key);
+    RUBY_CHECK(std::ranges::is_sorted(records, {}, &Record::key));
+
+    sort_by(records, &Record::name);
+    RUBY_CHECK(std::ranges::is_sorted(records, {}, &Record::name));
+  }
+
+  inline void test_group_by()
+  {
+    auto records = make_records(2000);
+    auto const groups = group_by(records, &Record::key);
+
+    RUBY_CHECK(groups.size() == 97 * 2 - 1);
+    std::size_t total = 0;
+    for(auto const & group : groups) {
+      for(auto const & record : group.elements)
+        RUBY_CHECK(record.key == group.key);
+      total += group.elements.size();
+    }
+    RUBY_CHECK(total == records.size());
+    RUBY_CHECK(std::ranges::is_sorted(groups, {}, [](auto const & g) { return g.key; }));
+  }
+
+  inline void run()
+  {
+    test_sortable_by_member();
+    test_radix_key_order();
+    test_stable_sort_by();
+    test_sort_by();
+    test_group_by();
+  }
+
+} // namespace sort_by_tests
@@ -0,0 +1,143 @@
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <ruby/invocable_traits/static_event_bus.hpp>
+
+#include "../check.hpp"
+
+namespace static_event_bus_tests
+{
+  using namespace ruby::inv;
+
+  struct key_pressed
+  {
+    char key;
+  };
+
+  struct resized
+  {
+    int width;
+    int height;
+  };
+
+  struct closed
+  {};
+
+  template<typename Bus, typename... Args>
+  concept CanPublish = requires(Bus & bus, Args &&... args)
+  {
+    bus.publish(std::forward<Args>(args)...);
+  };
+
+  inline void test_event_types()
+  {
+    auto by_value = [](key_pressed) {};
+    auto by_const_reference = [](resized const &) {};
+    auto by_rvalue = [](closed &&) {};
+    auto no_event = [] {};
+
+    static_assert(event_handler<decltype(by_value)>);
+    static_assert(!event_handler<decltype(by_rvalue)>);
+    static_assert(!event_handler<decltype(no_event)>);
+    static_assert(std::same_as<handled_event_t<decltype(by_const_reference)>, resized>);
+  }
+
+  inline void test_publish()
+  {
+    auto log = std::vector<std::string>();
+
+    auto bus = static_event_bus(
+        [&log](key_pressed const & e) { log.push_back(std::string("a:") + e.key); },
+        [&log](resized const & e) { log.push_back("b:" + std::to_string(e.width * e.height)); },
+        [&log](key_pressed e) { log.push_back(std::string("c:") + e.key); },
+        [count = 0](resized &, int extra) mutable { count += extra; });
+
+    using bus_type = decltype(bus);
+    static_assert(bus_type::subscribers<key_pressed> == 2);
+    static_assert(bus_type::subscribers<resized> == 2);
+    static_assert(bus_type::subscribers<resized const &> == 1);
+    static_assert(bus_type::subscribers<closed> == 0);
+
+    bus.publish(key_pressed {'x'}, 0);
+    auto size = resized {2, 3};
+    bus.publish(size, 5);
+    bus.publish(closed {}, 0);
+
+    RUBY_CHECK((log == std::vector<std::string> {"a:x", "c:x", "b:6"}));
+  }
+
+  inline void test_const_event()
+  {
+    auto log = std::vector<std::string>();
+
+    // Handlers taking the event by non-const reference do not receive const events.
+    auto bus = static_event_bus(
+        [&log](resized & e) { log.push_back("mutable:" + std::to_string(++e.width)); },
+        [&log](resized const & e) { log.push_back("const:" + std::to_string(e.width)); },
+        [&log](resized e, int extra) { log.push_back("copy:" + std::to_string(e.width + extra)); });
+
+    using bus_type = decltype(bus);
+    static_assert(bus_type::subscribers<resized &> == 3);
+    static_assert(bus_type::subscribers<resized const> == 2);
+
+    auto const fixed = resized {1, 1};
+    bus.publish(fixed, 10);
+    auto size = resized {1, 1};
+    bus.publish(size, 10);
+
+    RUBY_CHECK((log == std::vector<std::string> {"const:1", "copy:11", "mutable:2", "const:2",
+                                                 "copy:12"}));
+  }
+
+  inline void test_published_arguments()
+  {
+    auto bus = static_event_bus([](resized const &, std::string const &) {},
+                                [](key_pressed, int) {});
+    using bus_type = decltype(bus);
+    static_assert(bus_type::subscribers<resized> == 1);
+
+    // Every handler of the event must take the published arguments.
+    static_assert(CanPublish<bus_type, resized, std::string>);
+    static_assert(CanPublish<bus_type, resized, char const *, int>);
+    static_assert(!CanPublish<bus_type, resized, int>);
+    static_assert(!CanPublish<bus_type, resized>);
+    static_assert(CanPublish<bus_type, key_pressed, long>);
+    static_assert(!CanPublish<bus_type, key_pressed>);
+
+    // Events nobody handles take anything.
+    static_assert(CanPublish<bus_type, closed, resized>);
+    static_assert(CanPublish<bus_type, closed>);
+  }
+
+  inline void test_constexpr_publish()
+  {
+    struct counter
+    {
+      int * total;
+
+      constexpr void operator()(resized const & e) const
+      {
+        *total += e.width;
+      }
+    };
+
+    constexpr auto total = [] {
+      int total = 0;
+      auto bus = static_event_bus(counter {&total}, counter {&total});
+      bus.publish(resized {4, 0});
+      return total;
+    }();
+    static_assert(total == 8);
+  }
+
+  inline void run()
+  {
+    test_event_types();
+    test_publish();
+    test_const_event();
+    test_published_arguments();
+    test_constexpr_publish();
+  }
+
+} // namespace static_event_bus_tests
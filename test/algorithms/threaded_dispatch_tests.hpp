@@ -0,0 +1,136 @@
+
+#include <cstdint>
+#include <vector>
+#include <ruby/invocable_traits/threaded_dispatch.hpp>
+
+#include "../check.hpp"
+
+namespace threaded_dispatch_tests
+{
+  using namespace ruby::inv;
+
+  enum opcode : std::uint8_t
+  {
+    push,
+    add,
+    mul,
+    dup,
+    halt = 0xff
+  };
+
+  struct machine
+  {
+    std::uint8_t const * ip;
+    std::int64_t stack[64] = {};
+    int sp = 0;
+  };
+
+  constexpr auto decode = [](machine & m) { return *m.ip; };
+
+  constexpr auto op_push = [](machine & m) {
+    m.stack[m.sp++] = m.ip[1];
+    m.ip += 2;
+  };
+
+  constexpr auto op_add = [](machine & m) noexcept {
+    --m.sp;
+    m.stack[m.sp - 1] += m.stack[m.sp];
+    ++m.ip;
+  };
+
+  constexpr auto op_mul = [](machine & m) mutable {
+    --m.sp;
+    m.stack[m.sp - 1] *= m.stack[m.sp];
+    ++m.ip;
+  };
+
+  constexpr auto op_dup = [](machine & m) {
+    m.stack[m.sp] = m.stack[m.sp - 1];
+    ++m.sp;
+    ++m.ip;
+  };
+
+  template<typename... Handlers>
+  concept CanMakeDispatch = requires(Handlers... handlers)
+  {
+    make_threaded_dispatch(decode, handlers...);
+  };
+
+  inline void test_signature_checks()
+  {
+    int capture = 0;
+    auto stateful = [capture](machine &) { (void)capture; };
+    auto other_signature = [](machine &, int) {};
+    auto other_return = [](machine &) { return 0; };
+
+    static_assert(CanMakeDispatch<decltype(op_push), decltype(op_add), decltype(op_mul)>);
+    static_assert(!CanMakeDispatch<decltype(op_push), decltype(stateful)>);
+    static_assert(!CanMakeDispatch<decltype(op_push), decltype(other_signature)>);
+    static_assert(!CanMakeDispatch<decltype(op_push), decltype(other_return)>);
+    static_assert(!CanMakeDispatch<>);
+  }
+
+  inline void test_run()
+  {
+    constexpr auto vm = make_threaded_dispatch(decode, op_push, op_add, op_mul, op_dup);
+    static_assert(std::same_as<decltype(vm)::signature_type, void(machine &)>);
+    static_assert(vm.size == 4);
+    RUBY_CHECK(vm.handlers[add] != nullptr);
+
+    // (2 + 3) * (2 + 3) + 1
+    std::uint8_t const program[] = {push, 2, push, 3, add, dup, mul, push, 1, add, halt};
+    auto m = machine {program};
+    vm.run(m);
+    RUBY_CHECK(m.sp == 1);
+    RUBY_CHECK(m.stack[0] == 26);
+
+    auto n = machine {program};
+    vm.dispatch(push, n);
+    RUBY_CHECK(n.sp == 1 && n.stack[0] == 2);
+  }
+
+  inline void test_run_long_program()
+  {
+    constexpr auto vm = make_threaded_dispatch(decode, op_push, op_add, op_mul, op_dup);
+
+    auto program = std::vector<std::uint8_t> {push, 0};
+    for(int i = 0; i < 100000; ++i)
+      program.insert(program.end(), {push, 1, add});
+    program.push_back(halt);
+
+    auto m = machine {program.data()};
+    vm.run(m);
+    RUBY_CHECK(m.stack[0] == 100000);
+  }
+
+  struct counter
+  {
+    int remaining;
+    int steps = 0;
+  };
+
+  inline void test_run_result()
+  {
+    constexpr auto vm = make_threaded_dispatch(
+        [](counter & c) { return c.remaining > 0 ? 0 : 1; },
+        [](counter & c) {
+          --c.remaining;
+          return ++c.steps;
+        });
+
+    auto c = counter {5};
+    RUBY_CHECK(vm.run(c) == 5);
+
+    auto empty = counter {0};
+    RUBY_CHECK(vm.run(empty) == 0);
+  }
+
+  inline void run()
+  {
+    test_signature_checks();
+    test_run();
+    test_run_long_program();
+    test_run_result();
+  }
+
+} // namespace threaded_dispatch_tests
@@ -0,0 +1,122 @@
+
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <ruby/invocable_traits/to_expected.hpp>
+
+#include "../check.hpp"
+
+namespace to_expected_tests
+{
+  using namespace ruby::inv;
+
+  inline int parse(std::string const & text)
+  {
+    return std::stoi(text);
+  }
+
+  inline int twice(int x) noexcept
+  {
+    return 2 * x;
+  }
+
+  inline void test_types()
+  {
+    auto safe_parse = to_expected(&parse);
+    using wrapped = decltype(safe_parse);
+    static_assert(invoke_deducible<wrapped>);
+    static_assert(invocable_is_noexcept_v<wrapped>);
+    static_assert(std::same_as<wrapped::result_type, expected<int, std::exception_ptr>>);
+    static_assert(std::same_as<invocable_signature_t<wrapped>,
+                               expected<int, std::exception_ptr>(std::string const &)>);
+
+    static_assert(expected_wrappable<decltype(&twice)>);
+    static_assert(expected_wrappable<void (*)()>);
+    static_assert(!expected_wrappable<int & (*)()>);
+    static_assert(!expected_wrappable<void (*)(...)>);
+    static_assert(!expected_wrappable<decltype([](auto x) { return x; })>);
+  }
+
+  inline void test_catches()
+  {
+    auto safe_parse = to_expected(&parse);
+
+    auto parsed = safe_parse("42");
+    RUBY_CHECK(parsed.has_value() && *parsed == 42);
+
+    auto failed = safe_parse("forty-two");
+    RUBY_CHECK(!failed);
+    bool rethrown = false;
+    try {
+      std::rethrow_exception(failed.error());
+    } catch(std::invalid_argument const &) {
+      rethrown = true;
+    }
+    RUBY_CHECK(rethrown);
+
+    // Move-only results and void.
+    auto make = to_expected([](int x) {
+      if(x < 0)
+        throw std::out_of_range("negative");
+      return std::make_unique<int>(x);
+    });
+    RUBY_CHECK(**make(3) == 3);
+    RUBY_CHECK(!make(-1).has_value());
+
+    int calls = 0;
+    auto count = to_expected([&calls] { ++calls; });
+    static_assert(std::same_as<decltype(count()), expected<void, std::exception_ptr>>);
+    RUBY_CHECK(count().has_value() && calls == 1);
+  }
+
+  inline void test_error_type()
+  {
+    auto open = to_expected<std::system_error>([](int fd) {
+      if(fd < 0)
+        throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor));
+      return fd;
+    });
+
+    RUBY_CHECK(*open(3) == 3);
+    auto failed = open(-1);
+    RUBY_CHECK(!failed.has_value());
+    RUBY_CHECK(failed.error().code() == std::errc::bad_file_descriptor);
+
+    bool thrown = false;
+    try {
+      failed.value();
+    } catch(bad_expected_access<std::system_error> const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+  }
+
+  inline void test_noexcept_passthrough()
+  {
+    // Nothing to catch: the wrapper only converts the result.
+    auto safe_twice = to_expected(&twice);
+    using passthrough = decltype(safe_twice);
+    static_assert(noexcept(std::declval<passthrough &>()(21)));
+    RUBY_CHECK(*safe_twice(21) == 42);
+
+    // The catching wrapper is noexcept too, whatever its function throws.
+    auto calls = std::vector<decltype(to_expected(&parse))>();
+    for(int i = 0; i < 10; ++i)
+      calls.push_back(to_expected(&parse));
+    using wrapped = decltype(calls)::value_type;
+    static_assert(noexcept(std::declval<wrapped &>()(std::string())));
+    RUBY_CHECK(*calls.back()("7") == 7);
+  }
+
+  inline void run()
+  {
+    test_types();
+    test_catches();
+    test_error_type();
+    test_noexcept_passthrough();
+  }
+
+} // namespace to_expected_tests
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace test_support
+{
+  inline void check(bool condition, char const * expression, char const * file, int line)
+  {
+    if(!condition) {
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+      std::abort();
+    }
+  }
+} // namespace test_support
+
+#define RUBY_CHECK(...) \
+  ::test_support::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
@@ -0,0 +1,154 @@
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ruby/invocable_traits/actor.hpp>
+
+#include "../check.hpp"
+
+namespace actor_tests
+{
+  using namespace ruby::inv;
+
+  template<typename A, typename... Args>
+  concept CanPost = requires(A a, Args &&... args)
+  {
+    a.post(std::forward<Args>(args)...);
+  };
+
+  inline void test_message_type()
+  {
+    auto handler = [](int const &, std::string &&, double &) {};
+    using A = actor<decltype(handler)>;
+
+    static_assert(std::same_as<A::message_type, std::tuple<int, std::string, double>>);
+    static_assert(CanPost<A, int, char const *, double &>);
+    static_assert(!CanPost<A, int, char const *>);
+    static_assert(!CanPost<A, char const *, int, double>);
+  }
+
+  inline void test_spsc_ring()
+  {
+    auto ring = spsc_ring<std::unique_ptr<int>>(3);
+    RUBY_CHECK(ring.capacity() == 4);
+    RUBY_CHECK(ring.empty());
+
+    for(int i = 0; i < 4; ++i)
+      RUBY_CHECK(ring.try_emplace(std::make_unique<int>(i)));
+    RUBY_CHECK(!ring.try_emplace(std::make_unique<int>(4)));
+
+    int expected = 0;
+    auto check_next = [&](std::unique_ptr<int> && p) { RUBY_CHECK(*p == expected++); };
+    RUBY_CHECK(ring.drain(check_next, 3) == 3);
+    RUBY_CHECK(ring.try_emplace(std::make_unique<int>(4)));
+    RUBY_CHECK(ring.drain(check_next) == 2);
+    RUBY_CHECK(ring.empty());
+
+    ring.emplace(std::make_unique<int>(5));
+  }
+
+  inline void test_mpsc_ring()
+  {
+    auto ring = mpsc_ring<std::string>(2);
+    RUBY_CHECK(ring.try_emplace("a"));
+    RUBY_CHECK(ring.try_emplace(3, 'b'));
+    RUBY_CHECK(!ring.try_emplace("c"));
+
+    auto items = std::vector<std::string>();
+    ring.drain([&](std::string && s) { items.push_back(std::move(s)); });
+    RUBY_CHECK((items == std::vector<std::string> {"a", "bbb"}));
+    RUBY_CHECK(ring.empty());
+
+    ring.emplace("d");
+  }
+
+  inline void test_drain_throwing()
+  {
+    auto ring = spsc_ring<int>(4);
+    ring.emplace(1);
+    ring.emplace(2);
+
+    try {
+      ring.drain([](int) { throw 0; });
+    } catch(int) {
+    }
+
+    int value = 0;
+    RUBY_CHECK(ring.drain([&](int v) { value = v; }) == 1);
+    RUBY_CHECK(value == 2);
+  }
+
+  template<template<typename, typename> typename Mailbox, typename Wait>
+  inline void check_actor(int producers, int messages)
+  {
+    auto sums = std::vector<long long>(producers);
+    auto handler = [&sums](int producer, int value) { sums[producer] += value; };
+    auto a = actor<decltype(handler), Mailbox, Wait>(handler, 64);
+
+    {
+      auto consumer = std::jthread([&](std::stop_token stop) { a.run(stop); });
+      auto senders = std::vector<std::jthread>();
+      for(int p = 0; p < producers; ++p)
+        senders.emplace_back([&a, p, messages] {
+          for(int i = 1; i <= messages; ++i)
+            a.post(p, i);
+        });
+      senders.clear();
+    }
+    while(a.process() != 0) {
+    }
+
+    for(auto sum : sums)
+      RUBY_CHECK(sum == static_cast<long long>(messages) * (messages + 1) / 2);
+  }
+
+  inline void test_actor()
+  {
+    // spinning threads starve each other on machines with few cores, keep those runs short
+    check_actor<spsc_ring, spin_wait>(1, 100);
+    check_actor<spsc_ring, yield_wait>(1, 20000);
+    check_actor<spsc_ring, futex_wait>(1, 20000);
+    check_actor<mpsc_ring, spin_wait>(2, 100);
+    check_actor<mpsc_ring, yield_wait>(4, 20000);
+    check_actor<mpsc_ring, futex_wait>(4, 20000);
+  }
+
+  inline void test_actor_idle_stop()
+  {
+    auto count = std::atomic<int>(0);
+    auto a = mpsc_actor<std::function<void()>>(
+        [&count] {
+          ++count;
+          count.notify_one();
+        },
+        8);
+    {
+      auto consumer = std::jthread([&](std::stop_token stop) { a.run(stop); });
+      a.post();
+      count.wait(0);
+    }
+    RUBY_CHECK(count == 1);
+
+    // Messages posted before the stop request are handled before run returns.
+    {
+      auto consumer = std::jthread([&](std::stop_token stop) { a.run(stop); });
+      for(int i = 0; i < 5; ++i)
+        a.post();
+    }
+    RUBY_CHECK(count == 6);
+  }
+
+  inline void run()
+  {
+    test_message_type();
+    test_spsc_ring();
+    test_mpsc_ring();
+    test_drain_throwing();
+    test_actor();
+    test_actor_idle_stop();
+  }
+
+} // namespace actor_tests
@@ -0,0 +1,131 @@
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ruby/invocable_traits/lazy.hpp>
+
+#include "../check.hpp"
+
+namespace lazy_tests
+{
+  using namespace ruby::inv;
+
+  inline int global_setting = 3;
+
+  inline int & setting()
+  {
+    return global_setting;
+  }
+
+  template<typename F>
+  concept CanLazy = requires(F fn)
+  {
+    lazy(fn);
+  };
+
+  template<typename F>
+  concept CanLazyReference = requires(F fn)
+  {
+    lazy(allow_reference, fn);
+  };
+
+  inline void test_constraints()
+  {
+    auto returns_void = [] {};
+    auto returns_value = [] { return 0; };
+
+    static_assert(CanLazy<decltype(returns_value)>);
+    static_assert(!CanLazy<decltype(returns_void)>);
+    static_assert(!CanLazy<decltype(&setting)>);
+    static_assert(CanLazyReference<decltype(&setting)>);
+  }
+
+  inline void test_single_evaluation()
+  {
+    auto calls = std::atomic<int> {0};
+    auto const value = lazy(
+        [&calls](std::string prefix, int n) {
+          calls.fetch_add(1);
+          std::this_thread::yield();
+          return prefix + std::to_string(n);
+        },
+        "config-", 7);
+
+    RUBY_CHECK(!value.has_value());
+
+    auto threads = std::vector<std::jthread>();
+    auto mismatches = std::atomic<int> {0};
+    for(int i = 0; i < 8; ++i)
+      threads.emplace_back([&] {
+        for(int j = 0; j < 100; ++j)
+          if(*value != "config-7")
+            mismatches.fetch_add(1);
+      });
+    threads.clear();
+
+    RUBY_CHECK(calls.load() == 1);
+    RUBY_CHECK(mismatches.load() == 0);
+    RUBY_CHECK(value.has_value());
+    RUBY_CHECK(value->size() == 8);
+  }
+
+  inline void test_retry_after_exception()
+  {
+    int attempts = 0;
+    auto const value = lazy([&attempts](std::string text) {
+      if(++attempts == 1)
+        throw std::runtime_error("first attempt");
+      return text;
+    }, std::string("retried"));
+
+    bool thrown = false;
+    try {
+      (void)value.get();
+    } catch(std::runtime_error const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+    RUBY_CHECK(!value.has_value());
+    RUBY_CHECK(value.get() == "retried");
+    RUBY_CHECK(attempts == 2);
+  }
+
+  inline void test_reference()
+  {
+    auto const value = lazy(allow_reference, &setting);
+    static_assert(std::same_as<decltype(value.get()), int &>);
+    RUBY_CHECK(&value.get() == &global_setting);
+    value.get() = 4;
+    RUBY_CHECK(global_setting == 4);
+
+    auto const local = local_lazy(allow_reference, &setting);
+    RUBY_CHECK(&*local == &global_setting);
+  }
+
+  inline void test_local_lazy()
+  {
+    int calls = 0;
+    auto const value = local_lazy([&calls](std::vector<int> v) {
+      ++calls;
+      return v.size();
+    }, std::vector<int>(5));
+
+    static_assert(std::same_as<decltype(value)::reference, std::size_t const &>);
+    RUBY_CHECK(!value.has_value());
+    RUBY_CHECK(*value == 5);
+    RUBY_CHECK(value.get() == 5);
+    RUBY_CHECK(calls == 1);
+  }
+
+  inline void run()
+  {
+    test_constraints();
+    test_single_evaluation();
+    test_retry_after_exception();
+    test_reference();
+    test_local_lazy();
+  }
+
+} // namespace lazy_tests
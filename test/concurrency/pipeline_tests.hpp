@@ -0,0 +1,126 @@
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <ruby/invocable_traits/pipeline.hpp>
+
+#include "../check.hpp"
+
+namespace pipeline_tests
+{
+  using namespace ruby::inv;
+
+  inline int parse(std::string const & text)
+  {
+    return std::stoi(text);
+  }
+
+  inline void test_types()
+  {
+    auto twice = [](int x) { return 2 * x; };
+    auto sink = [](std::string) {};
+    static_assert(pipeline_stages<decltype(&parse)>);
+    static_assert(pipeline_stages<decltype(&parse), decltype(twice), void (*)(long)>);
+    static_assert(!pipeline_stages<>);
+    static_assert(!pipeline_stages<decltype(&parse), decltype(sink)>);
+    static_assert(!pipeline_stages<decltype(&parse), void (*)(int &)>);
+    static_assert(!pipeline_stages<void (*)(int), decltype(twice)>);
+    static_assert(!pipeline_stages<void (*)(), decltype(twice)>);
+    static_assert(!pipeline_stages<int (*)(int, int), decltype(twice)>);
+    static_assert(!pipeline_stages<decltype(&parse), decltype([](auto x) { return x; })>);
+
+    auto print = [](long) {};
+    using stages = stage_pipeline<futex_wait, decltype(&parse), decltype(twice), decltype(print)>;
+    static_assert(stages::stage_count == 3);
+    static_assert(std::same_as<stages::items, std::tuple<std::string, int, int>>);
+  }
+
+  inline void test_ordered()
+  {
+    auto results = std::vector<std::string>();
+    auto threads = std::vector<std::thread::id>();
+    {
+      auto p = pipeline(
+          4, &parse, [](int x) { return std::make_unique<int>(x * 3); },
+          [&threads](std::unique_ptr<int> x) {
+            threads.push_back(std::this_thread::get_id());
+            return std::to_string(*x);
+          },
+          [&results](std::string text) { results.push_back(std::move(text)); });
+
+      for(int i = 0; i < 1000; ++i)
+        p.push(std::to_string(i));
+      p.finish();
+      p.finish();
+    }
+
+    RUBY_CHECK(results.size() == 1000);
+    for(int i = 0; i < 1000; ++i)
+      RUBY_CHECK(results[i] == std::to_string(i * 3));
+    RUBY_CHECK(threads.front() != std::this_thread::get_id());
+  }
+
+  inline void test_backpressure()
+  {
+    auto released = std::atomic<bool>(false);
+    auto seen = std::atomic<int>(0);
+    auto p = pipeline<yield_wait>(
+        2, [](int x) { return x; },
+        [&](int) {
+          while(!released.load())
+            std::this_thread::yield();
+          ++seen;
+        });
+
+    // The blocked last stage holds one item, and each queue two more.
+    int pushed = 0;
+    while(pushed < 100 && p.try_push(pushed))
+      ++pushed;
+    RUBY_CHECK(pushed < 100);
+
+    released = true;
+    for(; pushed < 100; ++pushed)
+      p.push(pushed);
+    p.finish();
+    RUBY_CHECK(seen == 100);
+  }
+
+  inline void test_exceptions()
+  {
+    int sum = 0;
+    auto p = pipeline(
+        [](int x) {
+          if(x == 5)
+            throw std::invalid_argument("five");
+          return x;
+        },
+        [&sum](int x) { sum += x; });
+
+    for(int i = 0; i < 10; ++i)
+      p.push(i);
+
+    bool thrown = false;
+    try {
+      p.finish();
+    } catch(std::invalid_argument const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+
+    // Items after the failure are dropped by the failed stage.
+    RUBY_CHECK(sum == 0 + 1 + 2 + 3 + 4);
+  }
+
+  inline void run()
+  {
+    test_types();
+    test_ordered();
+    test_backpressure();
+    test_exceptions();
+  }
+
+} // namespace pipeline_tests
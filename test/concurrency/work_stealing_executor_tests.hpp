@@ -0,0 +1,195 @@
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <ruby/invocable_traits/work_stealing_executor.hpp>
+
+#include "../check.hpp"
+
+namespace work_stealing_executor_tests
+{
+  using namespace ruby::inv;
+
+  inline int square(int x) noexcept
+  {
+    return x * x;
+  }
+
+  struct Point
+  {
+    int x;
+  };
+
+  inline void test_task()
+  {
+    int calls = 0;
+    auto small = task([&calls] { ++calls; });
+    auto large = task([&calls, padding = std::array<char, 256> {}] { calls += 10; });
+    auto moved = std::move(large);
+
+    RUBY_CHECK(small && moved && !large);
+    small();
+    moved();
+    RUBY_CHECK(calls == 11);
+    RUBY_CHECK(!small && !moved);
+
+    auto owner = std::make_shared<int>(0);
+    auto pending = task([owner] {});
+    RUBY_CHECK(owner.use_count() == 2);
+    pending = task();
+    RUBY_CHECK(owner.use_count() == 1);
+  }
+
+  inline void test_submit_result_types()
+  {
+    auto executor = work_stealing_executor(2);
+    auto lambda = [](std::string s) { return s + "!"; };
+    auto value = 7;
+    auto reference = [&value]() -> int & { return value; };
+
+    static_assert(std::same_as<decltype(executor.submit(square, 3)), task_future<int>>);
+    static_assert(std::same_as<decltype(executor.submit(lambda, "x")), task_future<std::string>>);
+    static_assert(std::same_as<decltype(executor.submit(reference)), task_future<int &>>);
+    static_assert(std::same_as<decltype(executor.submit(&Point::x, Point {})), task_future<int>>);
+
+    RUBY_CHECK(executor.submit(square, 3).get() == 9);
+    RUBY_CHECK(executor.submit(lambda, "x").get() == "x!");
+    RUBY_CHECK(&executor.submit(reference).get() == &value);
+    RUBY_CHECK(executor.submit(&Point::x, Point {4}).get() == 4);
+  }
+
+  inline void test_submit_exception()
+  {
+    auto executor = work_stealing_executor(2);
+    auto future = executor.submit([] { throw std::runtime_error("failed"); });
+
+    auto caught = false;
+    try {
+      future.get();
+    } catch(std::runtime_error const &) {
+      caught = true;
+    }
+    RUBY_CHECK(caught);
+    RUBY_CHECK(!future.valid());
+  }
+
+  /** Converting an int to a Picky throws for negative values. */
+  struct Picky
+  {
+    int value;
+
+    Picky(int v)
+      : value(v)
+    {
+      if(v < 0)
+        throw std::invalid_argument("negative");
+    }
+  };
+
+  inline int picky_value(Picky p) noexcept
+  {
+    return p.value;
+  }
+
+  /** Moving a Loud throws. */
+  struct Loud
+  {
+    Loud() = default;
+
+    Loud(Loud &&)
+    {
+      throw std::runtime_error("moved");
+    }
+  };
+
+  inline Loud make_loud() noexcept
+  {
+    return Loud {};
+  }
+
+  inline void test_submit_conversion_exception()
+  {
+    auto executor = work_stealing_executor(2);
+
+    // The callable is noexcept, but converting its argument or moving its result is not.
+    RUBY_CHECK(executor.submit(&picky_value, 5).get() == 5);
+    auto converted = executor.submit(&picky_value, -1);
+    auto moved = executor.submit(&make_loud);
+
+    auto caught = 0;
+    try {
+      converted.get();
+    } catch(std::invalid_argument const &) {
+      ++caught;
+    }
+    try {
+      moved.get();
+    } catch(std::runtime_error const &) {
+      ++caught;
+    }
+    RUBY_CHECK(caught == 2);
+  }
+
+  inline long long fib(work_stealing_executor & executor, int n)
+  {
+    if(n < 12)
+      return n < 2 ? n : fib(executor, n - 1) + fib(executor, n - 2);
+
+    auto left = executor.submit([&executor, n] { return fib(executor, n - 1); });
+    auto const right = fib(executor, n - 2);
+    return left.get() + right;
+  }
+
+  inline void test_fork_join()
+  {
+    auto executor = work_stealing_executor(4);
+    RUBY_CHECK(executor.submit([&executor] { return fib(executor, 22); }).get() == 17711);
+  }
+
+  inline void test_wait_on_worker()
+  {
+    auto executor = work_stealing_executor(2);
+    auto released = std::atomic<bool>(false);
+
+    // One worker is blocked in 'slow', the other one waits for it with nothing to run.
+    auto slow = executor.submit([&released] {
+      released.wait(false);
+      return 42;
+    });
+    auto waiting = executor.submit([&slow] { return slow.get() + 1; });
+
+    released = true;
+    released.notify_all();
+    RUBY_CHECK(waiting.get() == 43);
+
+    // Futures released on other threads are reused by later submits.
+    for(int i = 0; i < 1000; ++i)
+      RUBY_CHECK(executor.submit(square, i).get() == i * i);
+  }
+
+  inline void test_post_and_shutdown()
+  {
+    auto counter = std::atomic<int>(0);
+    {
+      auto executor = work_stealing_executor(3);
+      for(int i = 0; i < 5000; ++i)
+        executor.post([&counter](int add) { counter.fetch_add(add); }, 1);
+    }
+    RUBY_CHECK(counter == 5000);
+  }
+
+  inline void run()
+  {
+    test_task();
+    test_submit_result_types();
+    test_submit_exception();
+    test_submit_conversion_exception();
+    test_fork_join();
+    test_wait_on_worker();
+    test_post_and_shutdown();
+  }
+
+} // namespace work_stealing_executor_tests
@@ -0,0 +1,157 @@
+
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ruby/invocable_traits/callback_arena.hpp>
+
+#include "../check.hpp"
+
+namespace callback_arena_tests
+{
+  using namespace ruby::inv;
+
+  template<typename Arena, typename F>
+  concept CanPush = requires(Arena & arena, F fn)
+  {
+    arena.push(fn);
+  };
+
+  inline void free_function(std::vector<int> & out, int value)
+  {
+    out.push_back(-value);
+  }
+
+  /** Counts allocations passed through to the default resource. */
+  class counting_resource : public std::pmr::memory_resource
+  {
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void * memory, std::size_t bytes, std::size_t alignment) override
+    {
+      std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override
+    {
+      return this == &other;
+    }
+
+  public:
+    int allocations = 0;
+  };
+
+  /** A callable that allocates through the allocator it is constructed with. */
+  struct pmr_callable
+  {
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::string text;
+
+    pmr_callable(std::string_view text, allocator_type allocator = {})
+      : text(text, allocator)
+    {}
+
+    pmr_callable(pmr_callable const & other, allocator_type allocator)
+      : text(other.text, allocator)
+    {}
+
+    void operator()(std::vector<int> & out, int value) const
+    {
+      out.push_back(static_cast<int>(text.size()) + value);
+    }
+  };
+
+  using Arena = callback_arena<void(std::vector<int> &, int)>;
+
+  inline void test_push_signature()
+  {
+    auto lambda = [](std::vector<int> &, int) {};
+    auto mutable_lambda = [](std::vector<int> &, int) mutable noexcept {};
+    auto wrong_argument = [](std::vector<int> &, long) {};
+    auto wrong_return = [](std::vector<int> &, int) { return 0; };
+    auto generic = [](auto &, int) {};
+
+    static_assert(CanPush<Arena, decltype(lambda)>);
+    static_assert(CanPush<Arena, decltype(mutable_lambda)>);
+    static_assert(CanPush<Arena, decltype(&free_function)>);
+    static_assert(!CanPush<Arena, decltype(wrong_argument)>);
+    static_assert(!CanPush<Arena, decltype(wrong_return)>);
+    static_assert(!CanPush<Arena, decltype(generic)>);
+  }
+
+  inline void test_invoke_in_order()
+  {
+    auto arena = Arena(64);
+    auto out = std::vector<int>();
+    auto owner = std::make_shared<int>(100);
+
+    arena.push([](std::vector<int> & v, int x) { v.push_back(x); });
+    arena.push(&free_function);
+    arena.push([owner](std::vector<int> & v, int x) { v.push_back(*owner + x); });
+    arena.push([big = std::array<int, 64> {}](std::vector<int> & v, int x) mutable {
+      big[0] += x;
+      v.push_back(big[0]);
+    });
+
+    RUBY_CHECK(arena.size() == 4);
+    arena.invoke(out, 1);
+    arena.invoke(out, 2);
+    RUBY_CHECK((out == std::vector<int> {1, -1, 101, 1, 2, -2, 102, 3}));
+    RUBY_CHECK(owner.use_count() == 2);
+
+    arena.reset();
+    RUBY_CHECK(arena.empty());
+    RUBY_CHECK(owner.use_count() == 1);
+  }
+
+  inline void test_reset_reuses_memory()
+  {
+    auto upstream = counting_resource();
+    auto arena = Arena(128, &upstream);
+    RUBY_CHECK(upstream.allocations == 1);
+
+    auto frame = [&] {
+      for(int i = 0; i < 100; ++i)
+        arena.push([i](std::vector<int> & v, int) { v.push_back(i); });
+      arena.reset();
+    };
+
+    frame();
+    auto const after_growth = upstream.allocations;
+    RUBY_CHECK(arena.capacity() > 128);
+
+    frame();
+    frame();
+    RUBY_CHECK(upstream.allocations == after_growth);
+  }
+
+  inline void test_pmr_callable()
+  {
+    auto upstream = counting_resource();
+    auto arena = Arena(4096, &upstream);
+    auto out = std::vector<int>();
+
+    arena.push(pmr_callable("a string longer than the small string buffer"));
+    RUBY_CHECK(upstream.allocations == 1);
+
+    arena.invoke(out, 0);
+    RUBY_CHECK(out.front() == 44);
+    arena.reset();
+  }
+
+  inline void run()
+  {
+    test_push_signature();
+    test_invoke_in_order();
+    test_reset_reuses_memory();
+    test_pmr_callable();
+  }
+
+} // namespace callback_arena_tests
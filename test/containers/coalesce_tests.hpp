@@ -0,0 +1,162 @@
+
+#include <chrono>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <ruby/invocable_traits/coalesce.hpp>
+
+#include "../check.hpp"
+
+namespace coalesce_tests
+{
+  using namespace ruby::inv;
+
+  /** A clock moved by hand. */
+  struct manual_clock
+  {
+    using rep = long;
+    using period = std::milli;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<manual_clock>;
+    static constexpr bool is_steady = true;
+
+    static inline time_point current {};
+
+    static time_point now() noexcept
+    {
+      return current;
+    }
+  };
+
+  struct metric
+  {
+    std::string name;
+    long value;
+  };
+
+  inline void test_types()
+  {
+    auto by_span = [](std::span<metric const>) {};
+    auto by_vector = [](std::vector<metric> const &) {};
+    auto generic = [](auto) {};
+    static_assert(batch_handler<decltype(by_span)>);
+    static_assert(batch_handler<void (*)(std::span<int>)>);
+    static_assert(!batch_handler<decltype(by_vector)>);
+    static_assert(!batch_handler<decltype(generic)>);
+    static_assert(!batch_handler<void (*)(std::span<int>, int)>);
+    static_assert(!batch_handler<void (*)(int)>);
+
+    // The coalescer takes one item, and is itself deducible.
+    using items = decltype(coalesce(by_span, 4));
+    static_assert(std::same_as<items::item_type, metric>);
+    static_assert(std::same_as<invocable_signature_t<items>, void(metric)>);
+  }
+
+  inline void test_flushes_when_full()
+  {
+    auto batches = std::vector<std::vector<long>>();
+    {
+      auto record = coalesce(
+          [&](std::span<metric const> batch) {
+            auto & values = batches.emplace_back();
+            for(auto const & m : batch)
+              values.push_back(m.value);
+          },
+          3);
+      RUBY_CHECK(record.capacity() == 3);
+
+      for(long i = 0; i < 7; ++i)
+        record({"requests", i});
+      RUBY_CHECK(batches.size() == 2);
+      RUBY_CHECK(record.size() == 1);
+
+      record.flush();
+      RUBY_CHECK(record.empty());
+      record.flush();
+      record({"requests", 7});
+    }
+
+    // The last item is flushed on destruction.
+    RUBY_CHECK((batches == std::vector<std::vector<long>> {{0, 1, 2}, {3, 4, 5}, {6}, {7}}));
+  }
+
+  inline void test_flushes_on_deadline()
+  {
+    using namespace std::chrono_literals;
+    auto sizes = std::vector<std::size_t>();
+    auto record = coalesce<manual_clock>(
+        [&](std::span<int> batch) { sizes.push_back(batch.size()); }, 100, 10ms);
+
+    record(1);
+    manual_clock::current += 5ms;
+    record(2);
+    RUBY_CHECK(!record.poll());
+    manual_clock::current += 5ms;
+
+    // The oldest item waited 10ms: the next call or poll flushes.
+    record(3);
+    RUBY_CHECK((sizes == std::vector<std::size_t> {3}));
+
+    record(4);
+    manual_clock::current += 20ms;
+    RUBY_CHECK(record.poll());
+    RUBY_CHECK(!record.poll());
+    RUBY_CHECK((sizes == std::vector<std::size_t> {3, 1}));
+  }
+
+  inline void test_consumes_items()
+  {
+    auto owned = std::vector<std::unique_ptr<int>>();
+    auto take = [&](std::span<std::unique_ptr<int>> batch) {
+      for(auto & p : batch)
+        owned.push_back(std::move(p));
+    };
+    auto record = coalesce(take, 2);
+    auto shared = std::make_shared<int>(0);
+
+    record(std::make_unique<int>(1));
+    record(std::make_unique<int>(2));
+    RUBY_CHECK(owned.size() == 2 && *owned[1] == 2);
+
+    // Items are destroyed even if the handler throws.
+    auto keep = [&](std::span<std::shared_ptr<int>>) { throw std::runtime_error("full"); };
+    auto failing = coalesce(keep, 8);
+    failing(shared);
+    RUBY_CHECK(shared.use_count() == 2);
+    bool thrown = false;
+    try {
+      failing.flush();
+    } catch(std::runtime_error const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+    RUBY_CHECK(failing.empty());
+    RUBY_CHECK(shared.use_count() == 1);
+
+    // Destruction flushes, and discards what the handler throws.
+    int batches = 0;
+    {
+      auto discarded = coalesce(
+          [&batches](std::span<std::shared_ptr<int>>) {
+            ++batches;
+            throw std::runtime_error("closed");
+          },
+          8);
+      discarded(shared);
+      RUBY_CHECK(shared.use_count() == 2);
+    }
+    RUBY_CHECK(batches == 1);
+    RUBY_CHECK(shared.use_count() == 1);
+  }
+
+  inline void run()
+  {
+    test_types();
+    test_flushes_when_full();
+    test_flushes_on_deadline();
+    test_consumes_items();
+  }
+
+} // namespace coalesce_tests
@@ -0,0 +1,98 @@
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <ruby/invocable_traits/deferred_call.hpp>
+
+#include "../check.hpp"
+
+namespace deferred_call_tests
+{
+  using namespace ruby::inv;
+
+  inline std::string describe(char a, double b, char c, std::int32_t d)
+  {
+    return std::string {a, c} + std::to_string(static_cast<int>(b)) + std::to_string(d);
+  }
+
+  template<typename F, typename... Args>
+  concept CanDefer = requires(F fn, Args... args)
+  {
+    deferred_call(fn, args...);
+  };
+
+  inline void test_layout()
+  {
+    using call = deferred_call<decltype(&describe)>;
+
+    // Declaration order pads each char up to the next field: 8 + 1 + 7 + 8 + 1 + 3 + 4.
+    struct in_order
+    {
+      decltype(&describe) fn;
+      char a;
+      double b;
+      char c;
+      std::int32_t d;
+    };
+    static_assert(sizeof(in_order) == 32);
+    static_assert(sizeof(call) == 24);
+
+    // An empty callable takes no space.
+    auto empty = [](double, char) {};
+    static_assert(sizeof(deferred_call<decltype(empty)>) == 16);
+
+    static_assert(std::same_as<call::arguments_type, std::tuple<char, double, char, std::int32_t>>);
+    static_assert(std::same_as<call::result_type, std::string>);
+  }
+
+  inline void test_call_restores_order()
+  {
+    auto call = deferred_call(&describe, 'x', 42.5, 'y', 7);
+    RUBY_CHECK(call.get<1>() == 'x');
+    RUBY_CHECK(call.get<2>() == 42.5);
+    RUBY_CHECK(call.get<3>() == 'y');
+    RUBY_CHECK(call.get<4>() == 7);
+    RUBY_CHECK(call() == "xy427");
+  }
+
+  inline void test_argument_categories()
+  {
+    auto consume = [](std::unique_ptr<int> p, int & counter, std::string const & text) {
+      counter += *p;
+      return text.size();
+    };
+
+    auto call = deferred_call(consume, std::make_unique<int>(5), 1, "abc");
+    static_assert(
+        std::same_as<decltype(call)::arguments_type, std::tuple<std::unique_ptr<int>, int, std::string>>);
+    RUBY_CHECK(call() == 3);
+    RUBY_CHECK(call.get<2>() == 6);
+    RUBY_CHECK(call.get<1>() == nullptr);
+
+    auto moved = std::move(call);
+    RUBY_CHECK(moved.get<2>() == 6);
+  }
+
+  inline void test_constraints()
+  {
+    auto two = [](int, std::string) {};
+    static_assert(CanDefer<decltype(two), int, char const *>);
+    static_assert(!CanDefer<decltype(two), int>);
+    static_assert(!CanDefer<decltype(two), int, std::string, int>);
+    static_assert(!CanDefer<decltype(two), std::string, int>);
+
+    constexpr auto sum = deferred_call([](int a, long b) { return a + b; }, 1, 2L);
+    static_assert(sum.get<2>() == 2L);
+  }
+
+  inline void run()
+  {
+    test_layout();
+    test_call_restores_order();
+    test_argument_categories();
+    test_constraints();
+  }
+
+} // namespace deferred_call_tests
@@ -0,0 +1,106 @@
+
+#include <string>
+#include <string_view>
+#include <ruby/invocable_traits/handler_registry.hpp>
+
+#include "../check.hpp"
+
+namespace handler_registry_tests
+{
+  using namespace ruby::inv;
+
+  inline int negate(int x, int)
+  {
+    return -x;
+  }
+
+  constexpr auto arithmetic = make_handler_registry<int(int, int)>(
+      named_handler {"add", [](int x, int y) { return x + y; }},
+      named_handler {"sub", [](int x, int y) noexcept { return x - y; }},
+      named_handler {"mul", [](int x, int y) { return x * y; }},
+      named_handler {"neg", &negate});
+
+  static_assert(arithmetic.size() == 4);
+  static_assert(arithmetic.index_of("mul") == 2);
+  static_assert(arithmetic.contains("neg"));
+  static_assert(!arithmetic.contains("div"));
+  static_assert(!arithmetic.contains(""));
+
+  template<typename Signature, typename F>
+  concept CanRegister = requires(F fn)
+  {
+    make_handler_registry<Signature>(named_handler {"f", fn});
+  };
+
+  inline void test_signature_validation()
+  {
+    auto exact = [](int, int) { return 0; };
+    auto other_args = [](int, long) { return 0; };
+    auto other_return = [](int, int) { return 0L; };
+    auto mutable_handler = [n = 0](int, int) mutable { return ++n; };
+
+    static_assert(CanRegister<int(int, int), decltype(exact)>);
+    static_assert(CanRegister<int(int, int), decltype(&negate)>);
+    static_assert(!CanRegister<int(int, int), decltype(other_args)>);
+    static_assert(!CanRegister<int(int, int), decltype(other_return)>);
+    static_assert(!CanRegister<int(int, int), decltype(mutable_handler)>);
+  }
+
+  inline void test_call()
+  {
+    RUBY_CHECK(arithmetic.call("add", 2, 3) == 5);
+    RUBY_CHECK(arithmetic.call("sub", 2, 3) == -1);
+    RUBY_CHECK(arithmetic.call("mul", 2, 3) == 6);
+    RUBY_CHECK(arithmetic.call("neg", 2, 3) == -2);
+    RUBY_CHECK(arithmetic.invoke(arithmetic.index_of("add"), 4, 4) == 8);
+
+    bool thrown = false;
+    try {
+      (void)arithmetic.call("div", 1, 1);
+    } catch(std::out_of_range const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+  }
+
+  inline void test_many_names()
+  {
+    auto const handler = [](std::string & out) { out += '.'; };
+    auto const registry = make_handler_registry<void(std::string &)>(
+        named_handler {"get", handler}, named_handler {"set", handler},
+        named_handler {"list", handler}, named_handler {"delete", handler},
+        named_handler {"watch", handler}, named_handler {"status", handler},
+        named_handler {"config", handler}, named_handler {"reload", handler},
+        named_handler {"start", handler}, named_handler {"stop", handler},
+        named_handler {"restart", handler}, named_handler {"health", handler},
+        named_handler {"metrics", handler}, named_handler {"version", handler},
+        named_handler {"help", handler}, named_handler {"quit", handler},
+        named_handler {"exit", handler});
+
+    for(std::size_t i = 0; i < registry.size(); ++i)
+      RUBY_CHECK(registry.index_of(registry.name(i)) == i);
+    RUBY_CHECK(!registry.contains("gett"));
+    RUBY_CHECK(!registry.contains("ge"));
+
+    auto out = std::string();
+    registry.call("quit", out);
+    RUBY_CHECK(out == ".");
+
+    bool thrown = false;
+    try {
+      (void)make_handler_registry<void(std::string &)>(named_handler {"a", handler},
+                                                       named_handler {"a", handler});
+    } catch(std::invalid_argument const &) {
+      thrown = true;
+    }
+    RUBY_CHECK(thrown);
+  }
+
+  inline void run()
+  {
+    test_signature_validation();
+    test_call();
+    test_many_names();
+  }
+
+} // namespace handler_registry_tests
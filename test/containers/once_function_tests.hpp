@@ -0,0 +1,216 @@
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ruby/invocable_traits/once_function.hpp>
+
+#include "../check.hpp"
+
+namespace once_function_tests
+{
+  using namespace ruby::inv;
+
+  /** A completion handler that gives its buffer away, so it can only be called once. */
+  struct take_buffer
+  {
+    std::vector<int> buffer;
+
+    std::vector<int> operator()(int extra) &&
+    {
+      buffer.push_back(extra);
+      return std::move(buffer);
+    }
+  };
+
+  /** Counts copies, moves and destructions of the payload of a once_function. */
+  struct probe
+  {
+    int * copies;
+    int * destroyed;
+
+    probe(int * c, int * d)
+      : copies(c)
+      , destroyed(d)
+    {}
+
+    probe(probe const & other)
+      : copies(other.copies)
+      , destroyed(other.destroyed)
+    {
+      ++*copies;
+    }
+
+    probe(probe && other) noexcept
+      : copies(std::exchange(other.copies, nullptr))
+      , destroyed(std::exchange(other.destroyed, nullptr))
+    {}
+
+    ~probe()
+    {
+      if(destroyed)
+        ++*destroyed;
+    }
+  };
+
+  template<typename F, typename... Args>
+  concept CanCallLvalue = requires(F & fn, Args... args)
+  {
+    fn(args...);
+  };
+
+  inline void test_rvalue_qualified()
+  {
+    static_assert(invocable_is_rvalue_reference_v<take_buffer>);
+    auto handler = once_function(take_buffer {{1, 2, 3}});
+    static_assert(std::same_as<decltype(handler), once_function<std::vector<int>(int)>>);
+    static_assert(!CanCallLvalue<decltype(handler), int>);
+
+    RUBY_CHECK(static_cast<bool>(handler));
+    auto result = std::move(handler)(4);
+    RUBY_CHECK((result == std::vector<int> {1, 2, 3, 4}));
+    RUBY_CHECK(!handler);
+  }
+
+  inline void test_moves_out_of_captures()
+  {
+    auto buffer = std::make_unique<std::array<int, 256>>();
+    (*buffer)[0] = 7;
+    auto const * address = buffer.get();
+
+    auto handler = once_function<std::unique_ptr<std::array<int, 256>>()>(
+        [buffer = std::move(buffer)]() mutable { return std::move(buffer); });
+    auto moved = std::move(handler);
+    RUBY_CHECK(!handler);
+
+    auto result = std::move(moved)();
+    RUBY_CHECK(result.get() == address);
+    RUBY_CHECK((*result)[0] == 7);
+  }
+
+  inline void test_destroys_after_call()
+  {
+    int copies = 0;
+    int destroyed = 0;
+    int calls = 0;
+
+    // Small payloads are stored inline, large ones are allocated: both behave the same.
+    auto small = once_function<void()>([p = probe(&copies, &destroyed), &calls] { ++calls; });
+    auto large = once_function<void()>(
+        [p = probe(&copies, &destroyed), &calls, padding = std::array<char, 256> {}] {
+          calls += 1 + padding[0];
+        });
+    RUBY_CHECK(destroyed == 0);
+
+    std::move(small)();
+    RUBY_CHECK(calls == 1);
+    RUBY_CHECK(destroyed == 1);
+    RUBY_CHECK(!small);
+
+    std::move(large)();
+    RUBY_CHECK(calls == 2);
+    RUBY_CHECK(destroyed == 2);
+    RUBY_CHECK(!large);
+    RUBY_CHECK(copies == 0);
+
+    // The payload is destroyed when the call throws as well.
+    auto throwing = once_function<int(int)>([p = probe(&copies, &destroyed)](int x) -> int {
+      throw std::runtime_error(std::to_string(x));
+    });
+    bool caught = false;
+    try {
+      std::move(throwing)(3);
+    } catch(std::runtime_error const & e) {
+      caught = std::string(e.what()) == "3";
+    }
+    RUBY_CHECK(caught);
+    RUBY_CHECK(destroyed == 3);
+    RUBY_CHECK(!throwing);
+  }
+
+  inline void test_relocation()
+  {
+    int copies = 0;
+    int destroyed = 0;
+    int calls = 0;
+
+    // Growing the vector relocates inline and allocated payloads without copying them.
+    auto pending = std::vector<once_function<void()>>();
+    for(int i = 0; i < 8; ++i) {
+      pending.emplace_back([p = probe(&copies, &destroyed), &calls] { ++calls; });
+      pending.emplace_back(
+          [p = probe(&copies, &destroyed), &calls, padding = std::array<char, 256> {}] {
+            calls += 1 + padding[0];
+          });
+    }
+    pending.reserve(pending.capacity() * 2);
+    RUBY_CHECK(copies == 0);
+    RUBY_CHECK(destroyed == 0);
+
+    for(std::size_t i = 0; i < pending.size(); i += 2)
+      std::move(pending[i])();
+    RUBY_CHECK(calls == 8);
+    RUBY_CHECK(destroyed == 8);
+
+    // Payloads never called are destroyed with their once_function, exactly once.
+    pending.clear();
+    RUBY_CHECK(calls == 8);
+    RUBY_CHECK(destroyed == 16);
+    RUBY_CHECK(copies == 0);
+  }
+
+  inline void test_conversions()
+  {
+    // Ordinary callables, with the result converted to the signature's return type.
+    auto twice = once_function<long(int)>([](int x) { return x * 2; });
+    RUBY_CHECK(std::move(twice)(21) == 42L);
+
+    auto discard = once_function<void(std::string)>([](std::string s) { return s.size(); });
+    std::move(discard)("ignored");
+
+    static_assert(!std::is_copy_constructible_v<once_function<void()>>);
+    static_assert(!std::is_constructible_v<once_function<void()>, int>);
+    static_assert(!std::is_constructible_v<once_function<int()>, void (*)()>);
+  }
+
+  inline void test_shared_storage_operations()
+  {
+    int total = 0;
+    int copies = 0;
+    int destroyed = 0;
+    auto add = [&total](int x) { total += x; };
+    auto sub = [&total](int x) { total -= x; };
+    auto owning = [p = std::make_unique<int>(1), q = probe(&copies, &destroyed)](int x) {
+      return *p + x;
+    };
+
+    // Trivially copyable callables, relocated next to ones that own resources, still call
+    // their own target, and each payload is destroyed once.
+    auto calls = std::vector<once_function<void(int)>>();
+    calls.emplace_back(add);
+    calls.emplace_back(sub);
+    calls.emplace_back(std::move(owning));
+    calls.emplace_back([big = std::array<long, 16> {5}, &total](int x) { total += x * big[0]; });
+    calls.emplace_back(add);
+    calls.reserve(calls.capacity() * 2);
+    RUBY_CHECK(destroyed == 0);
+    for(auto & call : calls)
+      std::move(call)(2);
+    RUBY_CHECK(total == 12);
+    RUBY_CHECK(destroyed == 1);
+    RUBY_CHECK(copies == 0);
+  }
+
+  inline void run()
+  {
+    test_rvalue_qualified();
+    test_moves_out_of_captures();
+    test_destroys_after_call();
+    test_relocation();
+    test_conversions();
+    test_shared_storage_operations();
+  }
+
+} // namespace once_function_tests
@@ -0,0 +1,145 @@
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include <ruby/invocable_traits/timer_wheel.hpp>
+
+#include "../check.hpp"
+
+namespace timer_wheel_tests
+{
+  using namespace ruby::inv;
+
+  inline void test_timer_callback()
+  {
+    auto nullary = [] {};
+    auto unary = [](int) {};
+    auto generic = [](auto...) {};
+    static_assert(timer_callback<decltype(nullary)>);
+    static_assert(timer_callback<int (*)()>);
+    static_assert(!timer_callback<decltype(unary)>);
+    static_assert(!timer_callback<decltype(generic)>);
+    static_assert(!timer_callback<void (*)(...)>);
+  }
+
+  inline void test_fires_at_deadline()
+  {
+    auto wheel = timer_wheel();
+    auto fired = std::vector<std::pair<std::uint64_t, std::uint64_t>>();
+
+    // Deadlines on every level and on the overflow list.
+    auto const deadlines = std::vector<std::uint64_t> {
+        1, 5, 255, 256, 300, 65'535, 70'000, 20'000'000, (std::uint64_t(1) << 32) + 5};
+    for(auto deadline : deadlines)
+      wheel.schedule_at(deadline, [&, deadline] { fired.emplace_back(deadline, wheel.now()); });
+    RUBY_CHECK(wheel.size() == deadlines.size());
+
+    RUBY_CHECK(wheel.advance(4) == 1);
+    RUBY_CHECK(wheel.now() == 4);
+    RUBY_CHECK(wheel.advance_to(70'000) == 6);
+    RUBY_CHECK(wheel.advance_to(std::uint64_t(1) << 33) == 2);
+    RUBY_CHECK(wheel.empty());
+
+    RUBY_CHECK(fired.size() == deadlines.size());
+    for(std::size_t i = 0; i < fired.size(); ++i) {
+      RUBY_CHECK(fired[i].first == deadlines[i]);
+      RUBY_CHECK(fired[i].second == deadlines[i]);
+    }
+  }
+
+  inline void test_cancel()
+  {
+    auto wheel = timer_wheel(16);
+    int calls = 0;
+    auto shared = std::make_shared<int>(0);
+
+    auto first = wheel.schedule(10, [&calls] { ++calls; });
+    auto second = wheel.schedule(1000, [&calls, shared] { ++calls; });
+    RUBY_CHECK(shared.use_count() == 2);
+    RUBY_CHECK(wheel.pending(second));
+
+    RUBY_CHECK(wheel.cancel(second));
+    RUBY_CHECK(shared.use_count() == 1);
+    RUBY_CHECK(!wheel.pending(second));
+    RUBY_CHECK(!wheel.cancel(second));
+
+    // A cancelled timer can be cancelled from a callback of the same tick.
+    auto third = timer_id();
+    wheel.schedule(10, [&] { calls += 10 * wheel.cancel(third); });
+    third = wheel.schedule(10, [&calls] { calls += 100; });
+
+    RUBY_CHECK(wheel.advance(2000) == 2);
+    RUBY_CHECK(calls == 11);
+    RUBY_CHECK(!wheel.cancel(first));
+
+    // Ids of released nodes are stale, even when the node is reused.
+    auto reused = wheel.schedule(1, [] {});
+    RUBY_CHECK(reused.index == first.index || reused.index == second.index ||
+               reused.index == third.index);
+    RUBY_CHECK(!wheel.pending(first) && !wheel.pending(second) && !wheel.pending(third));
+    RUBY_CHECK(wheel.pending(reused));
+  }
+
+  inline void test_rescheduling()
+  {
+    auto wheel = timer_wheel();
+    auto ticks = std::vector<std::uint64_t>();
+
+    // A periodic timer reschedules itself from its callback; a zero delay means the next tick.
+    struct periodic
+    {
+      timer_wheel * wheel;
+      std::vector<std::uint64_t> * ticks;
+      std::uint64_t period;
+
+      void operator()() const
+      {
+        ticks->push_back(wheel->now());
+        if(ticks->size() < 5)
+          wheel->schedule(period, *this);
+      }
+    };
+
+    wheel.schedule(0, periodic {&wheel, &ticks, 100});
+    wheel.advance(10'000);
+    RUBY_CHECK((ticks == std::vector<std::uint64_t> {1, 101, 201, 301, 401}));
+  }
+
+  inline void test_random_deadlines()
+  {
+    auto wheel = timer_wheel();
+    auto engine = std::mt19937_64(42);
+    auto delay = std::uniform_int_distribution<std::uint64_t>(0, 1 << 20);
+    auto step = std::uniform_int_distribution<std::uint64_t>(0, 1 << 12);
+
+    std::size_t scheduled = 0;
+    std::size_t on_time = 0;
+    std::size_t fired = 0;
+    for(int round = 0; round < 2000; ++round) {
+      for(int i = 0; i < 8; ++i) {
+        auto const deadline = wheel.now() + 1 + delay(engine);
+        wheel.schedule_at(deadline, [&wheel, &on_time, deadline] {
+          on_time += wheel.now() == deadline;
+        });
+        ++scheduled;
+      }
+      fired += wheel.advance(step(engine));
+    }
+    fired += wheel.advance(std::uint64_t(1) << 21);
+
+    RUBY_CHECK(wheel.empty());
+    RUBY_CHECK(fired == scheduled);
+    RUBY_CHECK(on_time == scheduled);
+  }
+
+  inline void run()
+  {
+    test_timer_callback();
+    test_fires_at_deadline();
+    test_cancel();
+    test_rescheduling();
+    test_random_deadlines();
+  }
+
+} // namespace timer_wheel_tests
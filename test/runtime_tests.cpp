@@ -0,0 +1,43 @@
+#include <cstdio>
+
+#include "./algorithms/apply_from_tests.hpp"
+#include "./algorithms/continuation_tests.hpp"
+#include "./algorithms/invoke_each_tests.hpp"
+#include "./algorithms/par_transform_tests.hpp"
+#include "./algorithms/sort_by_tests.hpp"
+#include "./algorithms/static_event_bus_tests.hpp"
+#include "./algorithms/threaded_dispatch_tests.hpp"
+#include "./algorithms/to_expected_tests.hpp"
+#include "./concurrency/actor_tests.hpp"
+#include "./concurrency/lazy_tests.hpp"
+#include "./concurrency/pipeline_tests.hpp"
+#include "./concurrency/work_stealing_executor_tests.hpp"
+#include "./containers/callback_arena_tests.hpp"
+#include "./containers/coalesce_tests.hpp"
+#include "./containers/deferred_call_tests.hpp"
+#include "./containers/handler_registry_tests.hpp"
+#include "./containers/once_function_tests.hpp"
+#include "./containers/timer_wheel_tests.hpp"
+
+int main()
+{
+  apply_from_tests::run();
+  continuation_tests::run();
+  invoke_each_tests::run();
+  par_transform_tests::run();
+  sort_by_tests::run();
+  static_event_bus_tests::run();
+  threaded_dispatch_tests::run();
+  to_expected_tests::run();
+  actor_tests::run();
+  lazy_tests::run();
+  pipeline_tests::run();
+  work_stealing_executor_tests::run();
+  callback_arena_tests::run();
+  coalesce_tests::run();
+  deferred_call_tests::run();
+  handler_registry_tests::run();
+  once_function_tests::run();
+  timer_wheel_tests::run();
+  puts("OK");
+}
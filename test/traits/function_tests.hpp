@@ -186,5 +186,35 @@ namespace function_tests
     static_assert(std::same_as<function_remove_qualifiers_t<void()>, void()>);
   }
 
+  inline void test_function_arg_properties()
+  {
+    struct non_trivial
+    {
+      ~non_trivial();
+      long value;
+    };
+
+    using Fn = void(char, double const &, non_trivial &&, int *, void (&)());
+    constexpr auto properties = function_arg_properties_v<Fn>;
+
+    static_assert(sizeof(arg_properties) == 8);
+    static_assert(properties.size() == 5);
+    static_assert(function_arg_properties_v<Fn0>.empty());
+
+    static_assert(properties[0].size == 1 && properties[0].alignment == 1);
+    static_assert(!properties[0].is_reference && properties[0].is_trivially_copyable);
+
+    static_assert(properties[1].size == sizeof(double) && properties[1].alignment == alignof(double));
+    static_assert(properties[1].is_reference && !properties[1].is_rvalue_reference);
+
+    static_assert(properties[2].is_rvalue_reference && properties[2].size == sizeof(long));
+    static_assert(!properties[2].is_trivially_copyable && !properties[2].is_trivially_destructible);
+
+    static_assert(properties[3].is_pointer && properties[3].is_trivially_destructible);
+
+    static_assert(properties[4].is_reference && properties[4].size == 0 && properties[4].alignment == 0);
+    static_assert(!properties[4].is_trivially_copyable);
+  }
+
 } // namespace function_tests
 
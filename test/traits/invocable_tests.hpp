@@ -88,5 +88,124 @@ namespace invocable_tests
     static_assert( std::same_as<invocable_function_t<decltype(&Fn4::x)>, char(Fn4&)> );
   }
 
+  inline void test_invocable_signature_t()
+  {
+    static_assert( std::same_as<invocable_signature_t<Fn0>, void(int)> );
+    static_assert( std::same_as<invocable_signature_t<Fn1>, int(int)> );
+    static_assert( std::same_as<invocable_signature_t<Fn2>, float(int)> );
+    static_assert( std::same_as<invocable_signature_t<Fn3>, double(int)> );
+    static_assert( std::same_as<invocable_signature_t<Fn1 const&>, int(int)> );
+  }
+
+  struct Overloaded{
+    int operator()(int) const;
+    double operator()(double) & noexcept;
+  };
+
+  struct ConstOverloaded{
+    int operator()(int) const;
+    long operator()(int);
+  };
+
+  struct RefOverloaded{
+    int operator()() const&;
+    long operator()() &&;
+  };
+
+  struct Converting{
+    int operator()(long) const;
+    int operator()(int) const;
+  };
+
+  struct FinalOverloaded final{
+    int operator()(int) const;
+    int operator()(int);
+  };
+
+  constexpr auto generic_fn = [](auto&&... xs){ return sizeof...(xs); };
+  constexpr auto generic_by_value_fn = [](auto x, auto y) noexcept { return x + y; };
+  constexpr auto template_fn = []<typename T>(std::tuple<T> const& t){ return std::get<0>(t); };
+
+  inline void test_invocable_traits_for()
+  {
+    using Generic = decltype(generic_fn);
+    using GenericByValue = decltype(generic_by_value_fn);
+    using Template = decltype(template_fn);
+
+    static_assert( std::same_as<invocable_function_for_t<Generic, int&, double>, std::size_t(int&, double&&) const> );
+    static_assert( std::same_as<invocable_function_for_t<Generic>, std::size_t() const> );
+    static_assert( std::same_as<invocable_function_for_t<GenericByValue, int&, int>, int(int, int) const noexcept> );
+    static_assert( std::same_as<invocable_function_for_t<Template, std::tuple<char>&>, char(std::tuple<char> const&) const> );
+    static_assert( std::same_as<invocable_function_for_t<Overloaded, int>, int(int) const> );
+    static_assert( std::same_as<invocable_function_for_t<Overloaded&, double>, double(double) & noexcept> );
+    static_assert( std::same_as<invocable_function_for_t<Fn1, int>, int(int) const> );
+    static_assert( std::same_as<invocable_function_for_t<Fn0, long>, void(int)> );
+
+    // The operator that overload resolution selects, for the value category and constness of F.
+    static_assert( std::same_as<invocable_function_for_t<ConstOverloaded&, int>, long(int)> );
+    static_assert( std::same_as<invocable_function_for_t<ConstOverloaded const&, int>, int(int) const> );
+    static_assert( std::same_as<invocable_function_for_t<ConstOverloaded, int>, long(int)> );
+    static_assert( std::same_as<invocable_function_for_t<RefOverloaded>, long() &&> );
+    static_assert( std::same_as<invocable_function_for_t<RefOverloaded&>, int() const&> );
+    static_assert( std::same_as<invocable_function_for_t<RefOverloaded const&&>, int() const&> );
+
+    // Calls converting their arguments.
+    static_assert( std::same_as<invocable_function_for_t<Overloaded, double>, int(int) const> );
+    static_assert( std::same_as<invocable_function_for_t<Converting, short>, int(int) const> );
+    static_assert( std::same_as<invocable_function_for_t<Converting, long&>, int(long) const> );
+    static_assert( std::same_as<invocable_function_for_t<Converting const&, char>, int(int) const> );
+    static_assert( std::same_as<invocable_function_for_t<Converting, unsigned char const&>, int(int) const> );
+    static_assert( !invoke_deducible_for<Converting, unsigned> );
+
+    static_assert( !invoke_deducible_for<FinalOverloaded, int> );
+    static_assert( !invoke_deducible_for<Fn1, int*> );
+    static_assert( !invoke_deducible_for<Fn4, int> );
+
+    static_assert( invocable_traits_for<Generic, int, int>::arity == 2 );
+    static_assert( invocable_traits_for<GenericByValue, int, int>::is_noexcept );
+  }
+
+  inline void test_signature_concepts()
+  {
+    static_assert( invocable_exactly<Fn1, int(int) const> );
+    static_assert( !invocable_exactly<Fn1, int(int)> );
+    static_assert( invocable_exactly<Fn3, double(int) noexcept> );
+
+    static_assert( invocable_as<Fn1, int(int)> );
+    static_assert( invocable_as<Fn3, double(int) const> );
+    static_assert( invocable_as<Fn0*, void(int) noexcept> );
+    static_assert( !invocable_as<Fn1, long(int)> );
+    static_assert( !invocable_as<Fn1, int(long)> );
+
+    static_assert( invocable_compatible<Fn1, long(short)> );
+    static_assert( invocable_compatible<Fn1, void(char)> );
+    static_assert( invocable_compatible<Fn2, double(int)> );
+    static_assert( !invocable_compatible<Fn2, double(int) const> );
+    static_assert( !invocable_compatible<Fn2, double(int) noexcept> );
+    static_assert( !invocable_compatible<Fn2, double(int) const noexcept> );
+    static_assert( invocable_compatible<Fn1, long(int) const &&> );
+    static_assert( !invocable_compatible<Fn1, long(int) noexcept> );
+    static_assert( invocable_compatible<Fn3, double(int) noexcept> );
+    static_assert( !invocable_compatible<Fn3, double(int) const noexcept> );
+    static_assert( !invocable_compatible<Fn1, int(int*)> );
+    static_assert( !invocable_compatible<Fn1, int(int, int)> );
+    static_assert( !invocable_compatible<Fn1, int*(int)> );
+    static_assert( !invocable_compatible<decltype(generic_fn), int(int)> );
+  }
+
+  inline void test_invocable_arg_properties()
+  {
+    static_assert( invocable_arg_properties_v<Fn1>.size() == 1 );
+    static_assert( invocable_arg_properties_v<Fn1>[0].size == sizeof(int) );
+    static_assert( invocable_arg_properties_v<decltype(&Fn4::x)>[0].is_reference );
+  }
+
+  inline void test_invocable_decayed_args_t()
+  {
+    static_assert( std::same_as<invocable_decayed_args_t<Fn0>, std::tuple<int>> );
+    static_assert( std::same_as<invocable_decayed_args_t<void(int const&, char(&)[2])>, std::tuple<int, char*>> );
+    static_assert( std::same_as<invocable_decayed_args_t<decltype(&Fn4::x)>, std::tuple<Fn4>> );
+  }
+
 }
 